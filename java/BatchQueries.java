@@ -0,0 +1,172 @@
+import data.DataAnalyzer;
+import data.DataProcessor.DataSelector;
+import data.DataProcessor.Query;
+import data.DataProcessor.StationSelector;
+import data.DataRecord.Type;
+import data.StationTrends.Estimator;
+import geo.GeoBox;
+import geo.GeoPoint;
+
+import java.io.BufferedReader;
+import java.io.File;
+import java.io.FileReader;
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.HashSet;
+import java.util.List;
+import java.util.Map;
+import java.util.Set;
+
+/**
+ * Parses a file of query specs for DataProcessor.processBatch(). Each non empty line that
+ * doesn't start with '#' is a query: a unique name followed by key=value options.
+ *
+ * <pre>
+ * # name     options
+ * hot_ok     analyzer=hot_days states=OK temp_f=95 years=1900-2017
+ * tavg_la    analyzer=tavg radius=34.05,-118.25,160
+ * points_tx  analyzer=data_points states=TX,OK
+ * prcp_nw    analyzer=prcp bbox=42,-125,49,-116
+ * </pre>
+ *
+ * <p>Options:</p>
+ * <ul>
+ * <li>analyzer=data_points|hot_days|tavg|prcp|records|trends (required)</li>
+ * <li>states=XX,YY,..., radius=LAT,LON,KM or bbox=MIN_LAT,MIN_LON,MAX_LAT,MAX_LON (one is
+ * required). The radius and bbox selections visit only the stations in their region.</li>
+ * <li>years=FIRST-LAST (default 1800-2100)</li>
+ * <li>temp_f=F, threshold of hot_days (default 95)</li>
+ * <li>trend=ols|theilsen, slope estimator of trends (default ols)</li>
+ * </ul>
+ */
+public class BatchQueries {
+
+  private static final int DEFAULT_FIRST_YEAR = 1800;
+  private static final int DEFAULT_LAST_YEAR = 2100;
+  private static final float DEFAULT_HOT_DAY_TEMP_F = 95f;
+
+  /** Parses the queries of the given spec file. */
+  public static List<Query> parse(File file) throws Exception {
+    final List<Query> result = new ArrayList<>();
+    final Set<String> names = new HashSet<>();
+    try (BufferedReader reader = new BufferedReader(new FileReader(file))) {
+      String line;
+      int lineNumber = 0;
+      while ((line = reader.readLine()) != null) {
+        lineNumber++;
+        line = line.trim();
+        if (line.isEmpty() || line.startsWith("#")) {
+          continue;
+        }
+        try {
+          final Query query = parseQuery(line);
+          if (!names.add(query.name)) {
+            throw new IllegalArgumentException("Duplicate query name: " + query.name);
+          }
+          result.add(query);
+        } catch (RuntimeException e) {
+          throw new IllegalArgumentException(
+              String.format("%s:%d: %s", file, lineNumber, e.getMessage()), e);
+        }
+      }
+    }
+    return result;
+  }
+
+  private static Query parseQuery(String line) {
+    final String[] tokens = line.split("\\s+");
+    final String name = tokens[0];
+    final Map<String, String> options = new HashMap<>();
+    for (int i = 1; i < tokens.length; i++) {
+      final int equals = tokens[i].indexOf('=');
+      if (equals <= 0) {
+        throw new IllegalArgumentException("Expected key=value: " + tokens[i]);
+      }
+      options.put(tokens[i].substring(0, equals), tokens[i].substring(equals + 1));
+    }
+
+    final StationSelector stationSelector = parseStationSelector(options);
+
+    int firstYear = DEFAULT_FIRST_YEAR;
+    int lastYear = DEFAULT_LAST_YEAR;
+    final String years = options.remove("years");
+    if (years != null) {
+      final String[] range = years.split("-");
+      if (range.length != 2) {
+        throw new IllegalArgumentException("Expected years=FIRST-LAST: " + years);
+      }
+      firstYear = Integer.parseInt(range[0]);
+      lastYear = Integer.parseInt(range[1]);
+    }
+
+    final String analyzerName = options.remove("analyzer");
+    final DataAnalyzer dataAnalyzer;
+    final DataSelector dataSelector;
+    if ("data_points".equals(analyzerName)) {
+      dataAnalyzer = new DataAnalyzerOfDataPoints();
+      dataSelector = new DataSelectorByTypeAndYearRange(firstYear, lastYear,
+          Type.TAVG, Type.TMAX, Type.TMIN, Type.PRCP);
+    } else if ("hot_days".equals(analyzerName)) {
+      final String tempF = options.remove("temp_f");
+      dataAnalyzer = new DataAnalyzerOfHotDays(Units.farenheitToCelcius(
+          tempF == null ? DEFAULT_HOT_DAY_TEMP_F : Float.parseFloat(tempF)));
+      dataSelector = new DataSelectorByTypeAndYearRange(firstYear, lastYear, Type.TMAX);
+    } else if ("tavg".equals(analyzerName)) {
+      dataAnalyzer = new DataAnalyzerOfTAvg();
+      dataSelector = new DataSelectorByTypeAndYearRange(firstYear, lastYear, Type.TAVG);
+    } else if ("prcp".equals(analyzerName)) {
+      dataAnalyzer = new DataAnalyzerOfPrecipitation();
+      dataSelector = new DataSelectorByTypeAndYearRange(firstYear, lastYear, Type.PRCP);
+    } else if ("records".equals(analyzerName)) {
+      dataAnalyzer = new DataAnalyzerOfDailyRecords();
+      dataSelector = new DataSelectorByTypeAndYearRange(firstYear, lastYear, Type.TMAX, Type.TMIN);
+    } else if ("trends".equals(analyzerName)) {
+      final String trend = options.remove("trend");
+      final Estimator estimator;
+      if (trend == null || "ols".equals(trend)) {
+        estimator = Estimator.OLS;
+      } else if ("theilsen".equals(trend)) {
+        estimator = Estimator.THEIL_SEN;
+      } else {
+        throw new IllegalArgumentException("Expected trend=ols|theilsen: " + trend);
+      }
+      dataAnalyzer = new DataAnalyzerOfStationTrends(estimator);
+      dataSelector = new DataSelectorByTypeAndYearRange(firstYear, lastYear, Type.TMAX, Type.TMIN);
+    } else {
+      throw new IllegalArgumentException("Unknown analyzer: " + analyzerName);
+    }
+
+    if (!options.isEmpty()) {
+      throw new IllegalArgumentException("Unexpected options: " + options.keySet());
+    }
+    return new Query(name, stationSelector, dataSelector, dataAnalyzer);
+  }
+
+  // Parses and removes the station selection options.
+  private static StationSelector parseStationSelector(Map<String, String> options) {
+    final String states = options.remove("states");
+    final String radius = options.remove("radius");
+    final String bbox = options.remove("bbox");
+    if ((states != null ? 1 : 0) + (radius != null ? 1 : 0) + (bbox != null ? 1 : 0) != 1) {
+      throw new IllegalArgumentException("Expected exactly one of states=, radius= or bbox=");
+    }
+    if (states != null) {
+      return new StationSelectorUsStates(states.split(","));
+    }
+    if (radius != null) {
+      final String[] values = radius.split(",");
+      if (values.length != 3) {
+        throw new IllegalArgumentException("Expected radius=LAT,LON,KM: " + radius);
+      }
+      return new StationsSelectorByRadius(
+          new GeoPoint(Float.parseFloat(values[0]), Float.parseFloat(values[1])),
+          Double.parseDouble(values[2]));
+    }
+    final String[] values = bbox.split(",");
+    if (values.length != 4) {
+      throw new IllegalArgumentException("Expected bbox=MIN_LAT,MIN_LON,MAX_LAT,MAX_LON: " + bbox);
+    }
+    return new StationsSelectorByBoundingBox(new GeoBox(Double.parseDouble(values[0]),
+        Double.parseDouble(values[1]), Double.parseDouble(values[2]), Double.parseDouble(values[3])));
+  }
+}
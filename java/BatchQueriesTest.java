@@ -0,0 +1,102 @@
+import data.DataProcessor.Query;
+import data.StationRecord;
+import org.junit.Test;
+
+import java.io.File;
+import java.io.PrintWriter;
+import java.util.List;
+
+import static org.junit.Assert.*;
+
+public class BatchQueriesTest {
+
+  // Parses a specs file with the given lines.
+  private static List<Query> parse(String... lines) throws Exception {
+    final File file = File.createTempFile("queries", ".txt");
+    file.deleteOnExit();
+    try (PrintWriter writer = new PrintWriter(file)) {
+      for (String line : lines) {
+        writer.println(line);
+      }
+    }
+    return BatchQueries.parse(file);
+  }
+
+  // Asserts that parsing the given lines fails with a message that contains the given text.
+  private static void assertParseError(String expected, String... lines) throws Exception {
+    try {
+      parse(lines);
+      fail("Expected an error: " + expected);
+    } catch (IllegalArgumentException e) {
+      assertTrue(e.getMessage(), e.getMessage().contains(expected));
+    }
+  }
+
+  // A stations file record of the given station and state at the given location.
+  private static StationRecord station(String id, float lat, float lon, String state) {
+    return StationRecord.parseFromTextLine(
+        String.format("%-11s %8.4f %9.4f  100.0 %-2s %-44s", id, lat, lon, state, "NAME"));
+  }
+
+  @Test
+  public void testParse() throws Exception {
+    final List<Query> queries = parse(
+        "# name     options",
+        "",
+        "hot_ok     analyzer=hot_days states=OK temp_f=100 years=1900-2017",
+        "  tavg_la  analyzer=tavg radius=34.05,-118.25,160",
+        "points_tx  analyzer=data_points states=TX,OK",
+        "prcp_nw    analyzer=prcp bbox=42,-125,49,-116",
+        "records    analyzer=records states=CA",
+        "trends_ts  analyzer=trends states=CA trend=theilsen");
+    assertEquals(6, queries.size());
+
+    assertEquals("hot_ok", queries.get(0).name);
+    assertTrue(queries.get(0).dataAnalyzer instanceof DataAnalyzerOfHotDays);
+    assertTrue(queries.get(0).stationSelector instanceof StationSelectorUsStates);
+    assertEquals("tavg_la", queries.get(1).name);
+    assertTrue(queries.get(1).dataAnalyzer instanceof DataAnalyzerOfTAvg);
+    assertTrue(queries.get(1).stationSelector instanceof StationsSelectorByRadius);
+    assertTrue(queries.get(2).dataAnalyzer instanceof DataAnalyzerOfDataPoints);
+    assertTrue(queries.get(3).dataAnalyzer instanceof DataAnalyzerOfPrecipitation);
+    assertTrue(queries.get(3).stationSelector instanceof StationsSelectorByBoundingBox);
+    assertTrue(queries.get(4).dataAnalyzer instanceof DataAnalyzerOfDailyRecords);
+    assertTrue(queries.get(5).dataAnalyzer instanceof DataAnalyzerOfStationTrends);
+  }
+
+  @Test
+  public void testStationSelectors() throws Exception {
+    final List<Query> queries = parse(
+        "states  analyzer=tavg states=TX,OK",
+        "radius  analyzer=tavg radius=34.05,-118.25,160",
+        "bbox    analyzer=tavg bbox=42,-125,49,-116");
+    final StationRecord oklahoma = station("USW00013967", 35.3889f, -97.6006f, "OK");
+    final StationRecord losAngeles = station("USW00023174", 33.9381f, -118.3889f, "CA");
+    final StationRecord seattle = station("USW00024233", 47.4444f, -122.3139f, "WA");
+
+    assertTrue(queries.get(0).stationSelector.onStation(oklahoma));
+    assertFalse(queries.get(0).stationSelector.onStation(losAngeles));
+    assertTrue(queries.get(1).stationSelector.onStation(losAngeles));
+    assertFalse(queries.get(1).stationSelector.onStation(seattle));
+    assertTrue(queries.get(2).stationSelector.onStation(seattle));
+    assertFalse(queries.get(2).stationSelector.onStation(oklahoma));
+  }
+
+  @Test
+  public void testErrors() throws Exception {
+    assertParseError(":2: Duplicate query name: q",
+        "q  analyzer=tavg states=OK",
+        "q  analyzer=prcp states=OK");
+    assertParseError("Expected key=value: states", "q  analyzer=tavg states");
+    assertParseError("Expected exactly one of", "q  analyzer=tavg");
+    assertParseError("Expected exactly one of", "q  analyzer=tavg states=OK bbox=42,-125,49,-116");
+    assertParseError("Expected radius=LAT,LON,KM", "q  analyzer=tavg radius=34.05,-118.25");
+    assertParseError("Expected bbox=", "q  analyzer=tavg bbox=42,-125,49");
+    assertParseError("Expected years=FIRST-LAST", "q  analyzer=tavg states=OK years=1900");
+    assertParseError("Unknown analyzer: null", "q  states=OK");
+    assertParseError("Unknown analyzer: foo", "q  analyzer=foo states=OK");
+    assertParseError("Expected trend=ols|theilsen", "q  analyzer=trends states=OK trend=median");
+    // Options of other analyzers are rejected.
+    assertParseError("Unexpected options: [temp_f]", "q  analyzer=tavg states=OK temp_f=95");
+  }
+}
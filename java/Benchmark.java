@@ -0,0 +1,260 @@
+import data.DataFileReader;
+import data.DataProcessor;
+import data.DataProcessor.StationSelector;
+import data.DataRecord;
+import data.DataRecord.Type;
+import data.KmlWriter;
+import data.LocalFileCache;
+import data.StationCube;
+import data.StationRecord;
+import data.StationRegistry;
+import data.StationSeries;
+import data.StationTrends.Estimator;
+
+import java.io.BufferedReader;
+import java.io.File;
+import java.io.FileReader;
+import java.io.PrintStream;
+import java.lang.management.ManagementFactory;
+import java.lang.management.MemoryPoolMXBean;
+import java.lang.management.MemoryUsage;
+import java.nio.file.Files;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.EnumMap;
+import java.util.List;
+import java.util.Map;
+
+/**
+ * Offline benchmarks of the ingest and analysis stages, using synthetic data from
+ * SyntheticData so no NOAA download is needed. Each benchmark is run a few times and the
+ * best run is reported, with its records (or placemarks, queries) per second and the peak
+ * memory of the process so far.
+ *
+ * <p>Usage: Benchmark [number of stations] [number of years]</p>
+ */
+public class Benchmark {
+  private final static PrintStream out = System.out;
+
+  private static final int DEFAULT_NUM_STATIONS = 200;
+  private static final int DEFAULT_NUM_YEARS = 50;
+  private static final int LAST_YEAR = 2017;
+  private static final long SEED = 1234;
+  private static final int ITERATIONS = 3;
+  // Number of layers of the KMZ benchmark, e.g. one per trend element.
+  private static final int KML_LAYERS = 3;
+
+  private interface Task {
+    void run() throws Exception;
+  }
+
+  private static final StationSelector ALL_STATIONS = new StationSelector() {
+    @Override
+    public boolean onStation(StationRecord station) {
+      return true;
+    }
+  };
+
+  private static final DataSelectorByTypeAndYearRange ALL_DATA =
+      new DataSelectorByTypeAndYearRange(1700, 2100, Type.values());
+
+  public static void main(String[] args) throws Exception {
+    final int numStations = args.length > 0 ? Integer.parseInt(args[0]) : DEFAULT_NUM_STATIONS;
+    final int numYears = args.length > 1 ? Integer.parseInt(args[1]) : DEFAULT_NUM_YEARS;
+
+    final File dir = Files.createTempDirectory("ghcn_bench").toFile();
+    try {
+      final SyntheticData syntheticData =
+          new SyntheticData(numStations, LAST_YEAR - numYears + 1, LAST_YEAR, SEED);
+      out.printf("Generating %d stations x %d years in %s\n", numStations, numYears, dir);
+      final List<String> stationIds = syntheticData.write(dir);
+      final long numRecords = syntheticData.numRecords();
+      final LocalFileCache cache = new LocalFileCache(dir.getPath());
+      runBenchmarks(cache, stationIds, numRecords);
+    } finally {
+      for (File file : dir.listFiles()) {
+        file.delete();
+      }
+      dir.delete();
+    }
+  }
+
+  private static void runBenchmarks(LocalFileCache cache, List<String> stationIds, long numRecords)
+      throws Exception {
+    final int numThreads = Runtime.getRuntime().availableProcessors();
+
+    bench("parse .dly", numRecords, () -> {
+      for (String stationId : stationIds) {
+        readRecords(cache, stationId, new ArrayList<>());
+      }
+    });
+
+    bench("ingest, 1 thread", numRecords, () ->
+        new DataProcessor(1, false).setQuiet(true).process(cache, ALL_STATIONS, ALL_DATA, new DataAnalyzerOfDataPoints()));
+
+    bench("ingest, " + numThreads + " threads", numRecords, () ->
+        new DataProcessor(numThreads, false).setQuiet(true).process(cache, ALL_STATIONS, ALL_DATA, new DataAnalyzerOfDataPoints()));
+
+    // Creates the binary series files, so the benchmark measures only their loading.
+    for (String stationId : stationIds) {
+      cache.loadStationSeries(stationId);
+    }
+    bench("ingest, series cache", numRecords, () ->
+        new DataProcessor(numThreads, true).setQuiet(true).process(cache, ALL_STATIONS, ALL_DATA, new DataAnalyzerOfDataPoints()));
+
+    // The analysis stage alone, on records that are already in memory.
+    final List<DataRecord> records = new ArrayList<>();
+    for (String stationId : stationIds) {
+      readRecords(cache, stationId, records);
+    }
+    final List<DataRecord> tMaxRecords = new ArrayList<>();
+    for (DataRecord data : records) {
+      if (data.type == Type.TMAX) {
+        tMaxRecords.add(data);
+      }
+    }
+    bench("aggregate data points", records.size(), () -> {
+      final DataAnalyzerOfDataPoints analyzer = new DataAnalyzerOfDataPoints();
+      for (DataRecord data : records) {
+        analyzer.onDataRecord(null, data);
+      }
+    });
+    bench("aggregate hot days", tMaxRecords.size(), () -> {
+      final DataAnalyzerOfHotDays analyzer = new DataAnalyzerOfHotDays(Units.farenheitToCelcius(95f));
+      for (DataRecord data : tMaxRecords) {
+        analyzer.onDataRecord(null, data);
+      }
+    });
+
+    bench("daily records, " + numThreads + " threads", numRecords, () ->
+        new DataProcessor(numThreads, true).setQuiet(true).process(cache, ALL_STATIONS,
+            new DataSelectorByTypeAndYearRange(1700, 2100, Type.TMAX, Type.TMIN),
+            new DataAnalyzerOfDailyRecords()));
+
+    for (Estimator estimator : Estimator.values()) {
+      bench("station trends " + estimator + ", " + numThreads + " threads", numRecords, () ->
+          new DataProcessor(numThreads, true).setQuiet(true).process(cache, ALL_STATIONS,
+              new DataSelectorByTypeAndYearRange(1700, 2100, Type.TMAX, Type.TMIN),
+              new DataAnalyzerOfStationTrends(estimator)));
+    }
+
+    // KMZ output of the selected stations, a placemark per station and layer. Counted in
+    // placemarks rather than records.
+    final StationRegistry registry = cache.loadStationRegistry();
+    final List<StationRecord> stations = new ArrayList<>();
+    for (String stationId : stationIds) {
+      stations.add(registry.stationRecord(registry.indexOf(stationId)));
+    }
+    final List<KmlWriter.Style> kmlStyles = Arrays.asList(
+        new KmlWriter.Style("warming", "ff0000ff", 0.8), new KmlWriter.Style("flat", "ffffffff", 0.6));
+    final File kmzFile = File.createTempFile("ghcn_bench", ".kmz");
+    final long numPlacemarks = (long) stations.size() * KML_LAYERS;
+    try {
+      bench("write kmz, " + KML_LAYERS + " layers", numPlacemarks, "placemarks", () -> {
+        try (KmlWriter kml = new KmlWriter(kmzFile, "benchmark", kmlStyles)) {
+          for (int layer = 0; layer < KML_LAYERS; layer++) {
+            final KmlWriter.Layer kmlLayer = kml.layer("layer " + layer);
+            for (StationRecord station : stations) {
+              kmlLayer.placemark(station.id, layer % 2 == 0 ? "warming" : "flat",
+                  station.geoPoint.lat, station.geoPoint.lon, station.name);
+            }
+          }
+        }
+      });
+    } finally {
+      kmzFile.delete();
+    }
+
+    // Cubes from the series cache, then queries of sliding 30 years windows of the summer
+    // months. Counted in queries.
+    final Map<Type, int[]> cubeThresholds = new EnumMap<>(Type.class);
+    cubeThresholds.put(Type.TMAX, new int[] {0, 300, 350});
+    final List<StationCube> cubes = new ArrayList<>();
+    bench("load station cubes", numRecords, () -> {
+      cubes.clear();
+      for (String stationId : stationIds) {
+        cubes.add(cache.loadStationCube(stationId, cubeThresholds));
+      }
+    });
+    final int summer = StationCube.monthSet(6, 7, 8);
+    final int windows = 100;
+    bench("station cube queries", (long) cubes.size() * windows, "queries", () -> {
+      long hotDays = 0;
+      for (StationCube cube : cubes) {
+        for (int i = 0; i < windows; i++) {
+          final int firstYear = LAST_YEAR - 30 - i;
+          hotDays += cube.countAbove(Type.TMAX, 2, firstYear, firstYear + 29, summer);
+        }
+      }
+      // Uses the result, so the JIT doesn't drop the loop.
+      if (hotDays < 0) {
+        throw new IllegalStateException();
+      }
+    });
+
+    bench("build station series", numRecords, () -> {
+      StationSeries series = null;
+      for (DataRecord data : records) {
+        if (series == null || series.stationKey != data.stationKey) {
+          series = new StationSeries(data.stationId());
+        }
+        series.add(data);
+      }
+    });
+  }
+
+  private static void readRecords(LocalFileCache cache, String stationId, List<DataRecord> result)
+      throws Exception {
+    final DataFileReader reader = new DataFileReader().open(cache.stationDataLocalFile(stationId));
+    try {
+      while (reader.readNext()) {
+        result.add(reader.parseTextLine());
+      }
+    } finally {
+      reader.close();
+    }
+  }
+
+  // Runs the task ITERATIONS times and reports the best run, in records per second.
+  private static void bench(String name, long numRecords, Task task) throws Exception {
+    bench(name, numRecords, "records", task);
+  }
+
+  // Runs the task ITERATIONS times and reports the best run, in the given units per second.
+  private static void bench(String name, long numUnits, String unit, Task task) throws Exception {
+    long bestNanos = Long.MAX_VALUE;
+    for (int i = 0; i < ITERATIONS; i++) {
+      final long startNanos = System.nanoTime();
+      task.run();
+      bestNanos = Math.min(bestNanos, System.nanoTime() - startNanos);
+    }
+    out.printf("%-28s %10.1f ms %14.0f %-14s   peak memory %6d MB\n", name,
+        bestNanos / 1e6, numUnits * 1e9 / bestNanos, unit + "/sec", peakMemoryBytes() / (1024 * 1024));
+  }
+
+  // Peak resident set size of the process on Linux. Elsewhere, the sum of the peak usage of
+  // the JVM memory pools.
+  private static long peakMemoryBytes() {
+    final File status = new File("/proc/self/status");
+    if (status.canRead()) {
+      try (BufferedReader reader = new BufferedReader(new FileReader(status))) {
+        String line;
+        while ((line = reader.readLine()) != null) {
+          if (line.startsWith("VmHWM:")) {
+            return Long.parseLong(line.replaceAll("[^0-9]", "")) * 1024;
+          }
+        }
+      } catch (Exception e) {
+        // Fall through to the JVM stats.
+      }
+    }
+    long result = 0;
+    for (MemoryPoolMXBean pool : ManagementFactory.getMemoryPoolMXBeans()) {
+      final MemoryUsage peakUsage = pool.getPeakUsage();
+      if (peakUsage != null) {
+        result += peakUsage.getUsed();
+      }
+    }
+    return result;
+  }
+}
@@ -0,0 +1,121 @@
+import data.BufferedTextWriter;
+import data.DailyRecordTracker;
+import data.DataAnalyzer;
+import data.DataRecord;
+import data.DataRecord.Type;
+import data.StationRecord;
+import data.YearSeries;
+
+/**
+ * Counts per year the daily record highs of TMAX and record lows of TMIN, where each station
+ * is compared only with its own history. The first value of each day of a station sets the
+ * baseline and is not counted as a record.
+ *
+ * <p>Records depend only on a single station so each station is analyzed by a partial
+ * analyzer on the DataProcessor threads, and only the per year counts are merged.</p>
+ */
+public class DataAnalyzerOfDailyRecords extends DataAnalyzer {
+
+  private static class AnnualData {
+    // Number of TMAX and TMIN daily values.
+    private int tMaxCount;
+    private int tMinCount;
+    // Number of new TMAX high and TMIN low daily records.
+    private int highMaxRecords;
+    private int lowMinRecords;
+
+    private void add(AnnualData other) {
+      tMaxCount += other.tMaxCount;
+      tMinCount += other.tMinCount;
+      highMaxRecords += other.highMaxRecords;
+      lowMinRecords += other.lowMinRecords;
+    }
+  }
+
+  // Trackers are reused by all the stations that are analyzed by a thread.
+  private static final ThreadLocal<DailyRecordTracker> HIGHS_TRACKER =
+      ThreadLocal.withInitial(() -> new DailyRecordTracker(true));
+  private static final ThreadLocal<DailyRecordTracker> LOWS_TRACKER =
+      ThreadLocal.withInitial(() -> new DailyRecordTracker(false));
+
+  private final YearSeries<AnnualData> dataSeries = new YearSeries<>(AnnualData::new);
+
+  // The trackers of the current station.
+  private DailyRecordTracker highs;
+  private DailyRecordTracker lows;
+
+  @Override
+  public void onStationStart(StationRecord station) {
+    highs = HIGHS_TRACKER.get();
+    highs.reset();
+    lows = LOWS_TRACKER.get();
+    lows.reset();
+  }
+
+  @Override
+  public void onDataRecord(StationRecord station, DataRecord data) {
+    final boolean isTMax = data.type == Type.TMAX;
+    if (!isTMax && data.type != Type.TMIN) {
+      throw new RuntimeException("Unexpected data type: " + data.type);
+    }
+    final DailyRecordTracker tracker = isTMax ? highs : lows;
+    final int firstDayOfMonth = DailyRecordTracker.dayOfYear(data.month, 1);
+    int count = 0;
+    int records = 0;
+    for (int i = 0; i < DataRecord.MAX_DAYS_IN_MONTH; i++) {
+      if (!data.hasValue(i)) {
+        continue;
+      }
+      count++;
+      if (tracker.update(firstDayOfMonth + i, data.year, data.rawValues[i])
+          == DailyRecordTracker.NEW_RECORD) {
+        records++;
+      }
+    }
+    if (count == 0) {
+      return;
+    }
+    final AnnualData annualData = dataSeries.getOrCreate(data.year);
+    if (isTMax) {
+      annualData.tMaxCount += count;
+      annualData.highMaxRecords += records;
+    } else {
+      annualData.tMinCount += count;
+      annualData.lowMinRecords += records;
+    }
+  }
+
+  @Override
+  public void onStationEnd(StationRecord station) {
+    highs = null;
+    lows = null;
+  }
+
+  @Override
+  public DataAnalyzer newPartialAnalyzer() {
+    return new DataAnalyzerOfDailyRecords();
+  }
+
+  @Override
+  public void mergePartialAnalyzer(DataAnalyzer partialAnalyzer) {
+    dataSeries.mergeFrom(((DataAnalyzerOfDailyRecords) partialAnalyzer).dataSeries, AnnualData::add);
+  }
+
+  @Override
+  public void dumpResults(BufferedTextWriter writer) {
+    writer.append("year, #tMax, high max records, #tMin, low min records").newLine();
+    final int[] years = dataSeries.yearRange();
+    for (int year : years) {
+      final AnnualData annualData = dataSeries.get(year);
+      if (annualData == null) {
+        writer.appendPadded(year, 4).append(',').newLine();
+      } else {
+        writer.appendPadded(year, 4)
+            .append(", ").appendPadded(annualData.tMaxCount, 7)
+            .append(", ").appendPadded(annualData.highMaxRecords, 7)
+            .append(", ").appendPadded(annualData.tMinCount, 7)
+            .append(", ").appendPadded(annualData.lowMinRecords, 7).newLine();
+      }
+    }
+  }
+}
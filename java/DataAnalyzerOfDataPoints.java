@@ -1,11 +1,12 @@
+import data.BufferedTextWriter;
 import data.DataAnalyzer;
 import data.DataRecord;
 import data.DataRecord.Type;
+import data.MonthStats;
 import data.StationRecord;
+import data.YearSeries;
 
 import java.io.PrintStream;
-import java.util.HashMap;
-import java.util.Map;
 
 public class DataAnalyzerOfDataPoints extends DataAnalyzer {
   private final static PrintStream out = System.out;
@@ -15,53 +16,64 @@ public class DataAnalyzerOfDataPoints extends DataAnalyzer {
     private int tMaxCount;
     private int tMinCount;
     private int prcpCount;
+
+    private void add(AnnualData other) {
+      tavgCount += other.tavgCount;
+      tMaxCount += other.tMaxCount;
+      tMinCount += other.tMinCount;
+      prcpCount += other.prcpCount;
+    }
   }
 
-  private Map<Integer, AnnualData> dataMap = new HashMap();
+  private final YearSeries<AnnualData> dataSeries = new YearSeries<>(AnnualData::new);
 
-  @Override
-  public void onStationStart(StationRecord station) {
-    out.printf("*** %s\n", station);
-  }
+  private final MonthStats monthStats = new MonthStats();
 
   @Override
   public void onDataRecord(StationRecord station, DataRecord data) {
-    AnnualData annualData = dataMap.get(data.year);
-    if (annualData == null) {
-      annualData = new AnnualData();
-      dataMap.put(data.year, annualData);
-    }
+    final AnnualData annualData = dataSeries.getOrCreate(data.year);
 
-    for (Float value : data.values) {
-      if (value != null) {
-        switch (data.type) {
-          case TAVG:
-            annualData.tavgCount++;
-            break;
-          case TMAX:
-            annualData.tMaxCount++;
-            break;
-          case TMIN:
-            annualData.tMinCount++;
-            break;
-          case PRCP:
-            annualData.prcpCount++;
-            break;
-        }
-      }
+    final int count = monthStats.compute(data.rawValues).count;
+    switch (data.type) {
+      case TAVG:
+        annualData.tavgCount += count;
+        break;
+      case TMAX:
+        annualData.tMaxCount += count;
+        break;
+      case TMIN:
+        annualData.tMinCount += count;
+        break;
+      case PRCP:
+        annualData.prcpCount += count;
+        break;
     }
   }
 
-  public void dumpResults(PrintStream ps) {
-    ps.print("year, #tAvg, #tMax, #tMin, #prcp\n");
-    final int[] years = computeYearRange(dataMap.keySet());
+  @Override
+  public DataAnalyzer newPartialAnalyzer() {
+    return new DataAnalyzerOfDataPoints();
+  }
+
+  @Override
+  public void mergePartialAnalyzer(DataAnalyzer partialAnalyzer) {
+    dataSeries.mergeFrom(((DataAnalyzerOfDataPoints) partialAnalyzer).dataSeries, AnnualData::add);
+  }
+
+  @Override
+  public void dumpResults(BufferedTextWriter writer) {
+    writer.append("year, #tAvg, #tMax, #tMin, #prcp").newLine();
+    final int[] years = dataSeries.yearRange();
     for (int year : years) {
-      final AnnualData annualData = dataMap.get(year);
+      final AnnualData annualData = dataSeries.get(year);
       if (annualData == null) {
-        ps.printf("%4d,\n", year);
+        writer.appendPadded(year, 4).append(',').newLine();
       } else {
-        ps.printf("%4d, %6d, %6d, %6d, %6d\n", year,
-          annualData.tavgCount, annualData.tMaxCount, annualData.tMinCount, annualData.prcpCount );
+        writer.appendPadded(year, 4)
+            .append(", ").appendPadded(annualData.tavgCount, 6)
+            .append(", ").appendPadded(annualData.tMaxCount, 6)
+            .append(", ").appendPadded(annualData.tMinCount, 6)
+            .append(", ").appendPadded(annualData.prcpCount, 6).newLine();
       }
     }
   }
@@ -69,10 +81,10 @@ public class DataAnalyzerOfDataPoints extends DataAnalyzer {
   public void chartResults() {
     out.println("Chart results no implemented");
 
-//    final int[] years = computeYearRange(dataMap.keySet());
+//    final int[] years = dataSeries.yearRange();
 //    final float[] values = new float[years.length];
 //    for (int i = 0; i < years.length; i++) {
-//      final AnnualData annualData = dataMap.get(years[i]);
+//      final AnnualData annualData = dataSeries.get(years[i]);
 //      if (annualData != null) {
 //        values[i] = ((float) annualData.sum) / annualData.count;
 //      }
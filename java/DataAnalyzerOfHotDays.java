@@ -1,9 +1,12 @@
+import data.BufferedTextWriter;
 import data.DataAnalyzer;
 import data.DataRecord;
+import data.DataRecord.Type;
+import data.MonthStats;
 import data.StationRecord;
+import data.YearSeries;
 
 import java.io.PrintStream;
-import java.util.*;
 
 public class DataAnalyzerOfHotDays extends DataAnalyzer {
 
@@ -11,15 +14,31 @@ public class DataAnalyzerOfHotDays extends DataAnalyzer {
 
   private static class AnnualData {
     private int totalCount;
-    private float hotCount;
+    private int hotCount;
+
+    private void add(AnnualData other) {
+      totalCount += other.totalCount;
+      hotCount += other.hotCount;
+    }
   }
 
-  private Map<Integer, AnnualData> dataMap = new HashMap();
+  private final YearSeries<AnnualData> dataSeries = new YearSeries<>(AnnualData::new);
+
+  private final MonthStats monthStats = new MonthStats();
 
   private final float tempC;
 
+  // The largest raw TMAX value that is not above tempC. Allows to compare the raw values
+  // with no float conversion.
+  private final int maxNotHotRawValue;
+
   public DataAnalyzerOfHotDays(float tempC) {
     this.tempC = tempC;
+    int rawValue = (int) Math.floor(tempC / Type.TMAX.scale(1)) - 2;
+    while (Type.TMAX.scale(rawValue + 1) <= tempC) {
+      rawValue++;
+    }
+    this.maxNotHotRawValue = rawValue;
   }
 
   @Override
@@ -28,44 +47,45 @@ public class DataAnalyzerOfHotDays extends DataAnalyzer {
       throw new RuntimeException("Unexpected data type: " + data.type);
     }
 
-    AnnualData annualData = dataMap.get(data.year);
-    if (annualData == null) {
-      annualData = new AnnualData();
-      dataMap.put(data.year, annualData);
-    }
+    final AnnualData annualData = dataSeries.getOrCreate(data.year);
 
-    for (Float value : data.values) {
-      if (value != null) {
-        annualData.totalCount++;
+    monthStats.compute(data.rawValues, maxNotHotRawValue, Integer.MIN_VALUE);
+    annualData.totalCount += monthStats.count;
+    annualData.hotCount += monthStats.aboveCount;
+  }
 
-        if (value > tempC) {
-          annualData.hotCount++;
-        }
-      }
-    }
+  @Override
+  public DataAnalyzer newPartialAnalyzer() {
+    return new DataAnalyzerOfHotDays(tempC);
+  }
 
+  @Override
+  public void mergePartialAnalyzer(DataAnalyzer partialAnalyzer) {
+    dataSeries.mergeFrom(((DataAnalyzerOfHotDays) partialAnalyzer).dataSeries, AnnualData::add);
   }
 
-  public void dumpResults(PrintStream ps) {
-    ps.print("year, hot days\n");
-    final int[] years = computeYearRange(dataMap.keySet());
+  @Override
+  public void dumpResults(BufferedTextWriter writer) {
+    writer.append("year, hot days").newLine();
+    final int[] years = dataSeries.yearRange();
     for (int year : years) {
-      final AnnualData annualData = dataMap.get(year);
+      final AnnualData annualData = dataSeries.get(year);
       if (annualData == null) {
-        ps.printf("%4d,\n", year);
+        writer.appendPadded(year, 4).append(',').newLine();
       } else {
-        ps.printf("%4d, %5.2f, %7d\n", year,
-          annualData.totalCount == 0 ? 0f : 365.0f * ((float)annualData.hotCount / annualData.totalCount), annualData.totalCount);
+        writer.appendPadded(year, 4)
+            .append(", ").appendFixed(annualData.totalCount == 0 ? 0f : 365.0f * ((float)annualData.hotCount / annualData.totalCount), 2, 5)
+            .append(", ").appendPadded(annualData.totalCount, 7).newLine();
       }
     }
   }
 
   public void chartResults() {
 
-    final int[] years = computeYearRange(dataMap.keySet());
+    final int[] years = dataSeries.yearRange();
     final float[] values = new float[years.length];
     for (int i = 0; i < years.length; i++) {
-      final AnnualData annualData = dataMap.get(years[i]);
+      final AnnualData annualData = dataSeries.get(years[i]);
       if (annualData != null) {
         values[i] = 365.0f * ((float) annualData.hotCount / annualData.totalCount);
       }
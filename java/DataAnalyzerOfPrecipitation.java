@@ -1,24 +1,30 @@
+import data.BufferedTextWriter;
 import data.DataAnalyzer;
 import data.DataRecord;
+import data.DataRecord.Type;
+import data.MonthStats;
 import data.StationRecord;
+import data.YearSeries;
 
 import java.io.PrintStream;
-import java.util.*;
 
 public class DataAnalyzerOfPrecipitation extends DataAnalyzer {
   private final static PrintStream out = System.out;
 
   private static class AnnualData {
     private int count;
-    private float sum;
+    // Sum of raw values. Exact, so results don't depend on the summing order.
+    private long rawSum;
+
+    private void add(AnnualData other) {
+      count += other.count;
+      rawSum += other.rawSum;
+    }
   }
 
-  private Map<Integer, AnnualData> dataMap = new HashMap();
+  private final YearSeries<AnnualData> dataSeries = new YearSeries<>(AnnualData::new);
 
-  @Override
-  public void onStationStart(StationRecord station) {
-    out.printf("*** %s\n", station);
-  }
+  private final MonthStats monthStats = new MonthStats();
 
   @Override
   public void onDataRecord(StationRecord station, DataRecord data) {
@@ -26,30 +32,35 @@ public class DataAnalyzerOfPrecipitation extends DataAnalyzer {
       throw new RuntimeException("Unexpected data type: " + data.type);
     }
 
-    AnnualData annualData = dataMap.get(data.year);
-    if (annualData == null) {
-      annualData = new AnnualData();
-      dataMap.put(data.year, annualData);
-    }
+    final AnnualData annualData = dataSeries.getOrCreate(data.year);
 
-    for (Float value : data.values) {
-      if (value != null) {
-        annualData.count++;
-        annualData.sum += value;
-      }
-    }
+    monthStats.compute(data.rawValues);
+    annualData.count += monthStats.count;
+    annualData.rawSum += monthStats.sum;
   }
 
-  public void dumpResults(PrintStream ps) {
-    ps.print("year, percp inch\n");
-    final int[] years = computeYearRange(dataMap.keySet());
+  @Override
+  public DataAnalyzer newPartialAnalyzer() {
+    return new DataAnalyzerOfPrecipitation();
+  }
+
+  @Override
+  public void mergePartialAnalyzer(DataAnalyzer partialAnalyzer) {
+    dataSeries.mergeFrom(((DataAnalyzerOfPrecipitation) partialAnalyzer).dataSeries, AnnualData::add);
+  }
+
+  @Override
+  public void dumpResults(BufferedTextWriter writer) {
+    writer.append("year, percp inch").newLine();
+    final int[] years = dataSeries.yearRange();
     for (int year : years) {
-      final AnnualData annualData = dataMap.get(year);
+      final AnnualData annualData = dataSeries.get(year);
       if (annualData == null) {
-        ps.printf("%4d,\n", year);
+        writer.appendPadded(year, 4).append(',').newLine();
       } else {
-        ps.printf("%4d, %5.2f, %7d\n", year,
-          annualData.count == 0 ? 0f : 365.0f * (annualData.sum / annualData.count) / 25.4, annualData.count);
+        writer.appendPadded(year, 4)
+            .append(", ").appendFixed(annualData.count == 0 ? 0f : 365.0f * (float) (Type.PRCP.scaleSum(annualData.rawSum) / annualData.count) / 25.4, 2, 5)
+            .append(", ").appendPadded(annualData.count, 7).newLine();
       }
     }
   }
@@ -0,0 +1,155 @@
+import data.BufferedTextWriter;
+import data.DataAnalyzer;
+import data.DataRecord;
+import data.Decimals;
+import data.KmlWriter;
+import data.RegressionAccumulator;
+import data.StationRecord;
+import data.StationSeries;
+import data.StationTrends;
+import data.StationTrends.Element;
+import data.StationTrends.Estimator;
+import data.StationTrendsFile;
+
+import java.io.File;
+import java.io.IOException;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+
+/**
+ * Computes the per month TMAX, TMIN and anomaly trends of each station (see StationTrends),
+ * by least squares or Theil-Sen. Each station is analyzed by a partial analyzer on the
+ * DataProcessor threads.
+ *
+ * <p>The least squares regressions of the stations are also pooled, with the partial
+ * analyzers, into within station trends over all the stations (station "ALL", see
+ * StationTrends.fromPooledRegressions()). Unlike the mean of the station slopes, they weigh
+ * stations by their number of years. Their years column is the number of stations. They are
+ * least squares whatever the estimator, and named "ALL_OLS" with Theil-Sen.</p>
+ *
+ * <p>Results: a CSV line per station, element and month with a trend, a binary table (see
+ * StationTrendsFile) and a KMZ file with a layer per element, where stations are colored by
+ * the mean of their monthly slopes.</p>
+ */
+public class DataAnalyzerOfStationTrends extends DataAnalyzer {
+
+  // Mean slopes, in C per century, above which a station is shown as warming or cooling.
+  private static final double KML_SLOPE_THRESHOLD = 0.5;
+
+  // Station column of the trends pooled over all the stations, with the OLS and Theil-Sen
+  // estimators. The pooled trends are least squares in both cases.
+  private static final String POOLED_STATION_ID = "ALL";
+  private static final String POOLED_OLS_STATION_ID = "ALL_OLS";
+
+  private static final List<KmlWriter.Style> KML_STYLES = Arrays.asList(
+      new KmlWriter.Style("warming", "ff0000ff", 0.8),
+      new KmlWriter.Style("cooling", "ffff0000", 0.8),
+      new KmlWriter.Style("flat", "ffffffff", 0.6));
+
+  private final Estimator estimator;
+
+  // The analyzed stations and their trends, in the stations order.
+  private final List<StationRecord> stations = new ArrayList<>();
+  private final List<StationTrends> trends = new ArrayList<>();
+
+  // Per slot, the regressions of the stations with a trend in the slot, merged within
+  // stations, and the number of these stations. Least squares, whatever the estimator.
+  private final RegressionAccumulator[] pooledRegressions = StationTrends.newRegressions();
+  private final int[] pooledStations = new int[StationTrends.SLOTS];
+
+  // The data of the current station.
+  private StationSeries series;
+
+  public DataAnalyzerOfStationTrends(Estimator estimator) {
+    this.estimator = estimator;
+  }
+
+  @Override
+  public void onStationStart(StationRecord station) {
+    series = new StationSeries(station.id);
+  }
+
+  @Override
+  public void onDataRecord(StationRecord station, DataRecord data) {
+    series.add(data);
+  }
+
+  @Override
+  public void onStationEnd(StationRecord station) {
+    stations.add(station);
+    final RegressionAccumulator[] regressions = StationTrends.newRegressions();
+    trends.add(StationTrends.compute(series, estimator, regressions));
+    for (int slot = 0; slot < StationTrends.SLOTS; slot++) {
+      if (regressions[slot].count() >= StationTrends.MIN_YEARS) {
+        pooledRegressions[slot].mergeWithinGroups(regressions[slot]);
+        pooledStations[slot]++;
+      }
+    }
+    series = null;
+  }
+
+  @Override
+  public DataAnalyzer newPartialAnalyzer() {
+    return new DataAnalyzerOfStationTrends(estimator);
+  }
+
+  @Override
+  public void mergePartialAnalyzer(DataAnalyzer partialAnalyzer) {
+    final DataAnalyzerOfStationTrends other = (DataAnalyzerOfStationTrends) partialAnalyzer;
+    stations.addAll(other.stations);
+    trends.addAll(other.trends);
+    for (int slot = 0; slot < StationTrends.SLOTS; slot++) {
+      pooledRegressions[slot].mergeWithinGroups(other.pooledRegressions[slot]);
+      pooledStations[slot] += other.pooledStations[slot];
+    }
+  }
+
+  @Override
+  public void dumpResults(BufferedTextWriter writer) {
+    StationTrends.writeCsvHeader(writer);
+    for (StationTrends stationTrends : trends) {
+      stationTrends.writeCsv(writer);
+    }
+    StationTrends.fromPooledRegressions(
+        estimator == Estimator.OLS ? POOLED_STATION_ID : POOLED_OLS_STATION_ID,
+        pooledRegressions, pooledStations).writeCsv(writer);
+  }
+
+  @Override
+  public void writeOutputFiles(String baseName) throws IOException {
+    StationTrendsFile.write(new File(baseName + ".trends"), trends);
+    try (KmlWriter kml = new KmlWriter(new File(baseName + ".kmz"), baseName, KML_STYLES)) {
+      final KmlWriter.Layer[] layers = new KmlWriter.Layer[Element.values().length];
+      for (Element element : Element.values()) {
+        layers[element.ordinal()] = kml.layer(element.name() + " trend");
+      }
+      final StringBuilder description = new StringBuilder();
+      for (int i = 0; i < trends.size(); i++) {
+        final StationRecord station = stations.get(i);
+        final StationTrends stationTrends = trends.get(i);
+        for (Element element : Element.values()) {
+          final double meanSlope = stationTrends.meanSlope(element);
+          if (Double.isNaN(meanSlope)) {
+            continue;
+          }
+          final String styleId = meanSlope > KML_SLOPE_THRESHOLD ? "warming"
+              : meanSlope < -KML_SLOPE_THRESHOLD ? "cooling" : "flat";
+          description.setLength(0);
+          description.append(station.name).append(", C/century by month:");
+          for (int month = 1; month <= 12; month++) {
+            final int slot = StationTrends.slot(element, month);
+            description.append(' ');
+            if (stationTrends.hasTrend(slot)) {
+              Decimals.appendFixed(description, stationTrends.slopes[slot], 2);
+            } else {
+              description.append('-');
+            }
+          }
+          layers[element.ordinal()].placemark(station.id, styleId, station.geoPoint.lat,
+              station.geoPoint.lon, description.toString());
+        }
+      }
+    }
+  }
+}
@@ -1,25 +1,30 @@
+import data.BufferedTextWriter;
 import data.DataAnalyzer;
 import data.DataRecord;
+import data.DataRecord.Type;
+import data.MonthStats;
 import data.StationRecord;
+import data.YearSeries;
 
 import java.io.PrintStream;
-import java.util.HashMap;
-import java.util.Map;
 
 public class DataAnalyzerOfTAvg extends DataAnalyzer {
   private final static PrintStream out = System.out;
 
   private static class AnnualData {
     private int count;
-    private float sum;
+    // Sum of raw values. Exact, so results don't depend on the summing order.
+    private long rawSum;
+
+    private void add(AnnualData other) {
+      count += other.count;
+      rawSum += other.rawSum;
+    }
   }
 
-  private Map<Integer, AnnualData> dataMap = new HashMap();
+  private final YearSeries<AnnualData> dataSeries = new YearSeries<>(AnnualData::new);
 
-  @Override
-  public void onStationStart(StationRecord station) {
-    out.printf("*** %s\n", station);
-  }
+  private final MonthStats monthStats = new MonthStats();
 
   @Override
   public void onDataRecord(StationRecord station, DataRecord data) {
@@ -27,42 +32,47 @@ public class DataAnalyzerOfTAvg extends DataAnalyzer {
       throw new RuntimeException("Unexpected data type: " + data.type);
     }
 
-    AnnualData annualData = dataMap.get(data.year);
-    if (annualData == null) {
-      annualData = new AnnualData();
-      dataMap.put(data.year, annualData);
-    }
+    final AnnualData annualData = dataSeries.getOrCreate(data.year);
 
-    for (Float value : data.values) {
-      if (value != null) {
-        annualData.count++;
-        annualData.sum += value;
-      }
-    }
+    monthStats.compute(data.rawValues);
+    annualData.count += monthStats.count;
+    annualData.rawSum += monthStats.sum;
   }
 
-  public void dumpResults(PrintStream ps) {
-    ps.print("year, tavg\n");
-    final int[] years = computeYearRange(dataMap.keySet());
+  @Override
+  public DataAnalyzer newPartialAnalyzer() {
+    return new DataAnalyzerOfTAvg();
+  }
+
+  @Override
+  public void mergePartialAnalyzer(DataAnalyzer partialAnalyzer) {
+    dataSeries.mergeFrom(((DataAnalyzerOfTAvg) partialAnalyzer).dataSeries, AnnualData::add);
+  }
+
+  @Override
+  public void dumpResults(BufferedTextWriter writer) {
+    writer.append("year, tavg").newLine();
+    final int[] years = dataSeries.yearRange();
     for (int year : years) {
-      final AnnualData annualData = dataMap.get(year);
+      final AnnualData annualData = dataSeries.get(year);
       if (annualData == null) {
-        ps.printf("%4d,\n", year);
+        writer.appendPadded(year, 4).append(',').newLine();
       } else {
-        ps.printf("%4d, %2.2f, %7d\n", year,
-          annualData.count == 0 ? 0f : annualData.sum / annualData.count, annualData.count);
+        writer.appendPadded(year, 4)
+            .append(", ").appendFixed(annualData.count == 0 ? 0f : (float) (Type.TAVG.scaleSum(annualData.rawSum) / annualData.count), 2, 2)
+            .append(", ").appendPadded(annualData.count, 7).newLine();
       }
     }
   }
 
   public void chartResults() {
 
-    final int[] years = computeYearRange(dataMap.keySet());
+    final int[] years = dataSeries.yearRange();
     final float[] values = new float[years.length];
     for (int i = 0; i < years.length; i++) {
-      final AnnualData annualData = dataMap.get(years[i]);
+      final AnnualData annualData = dataSeries.get(years[i]);
       if (annualData != null) {
-        values[i] = ((float) annualData.sum) / annualData.count;
+        values[i] = (float) (Type.TAVG.scaleSum(annualData.rawSum) / annualData.count);
       }
 
     }
@@ -1,4 +1,7 @@
+import com.sun.istack.internal.Nullable;
+import data.BufferedTextWriter;
 import data.DataProcessor;
+import data.DataProcessor.Query;
 import data.DataProcessor.StationSelector;
 import data.DataProcessor.DataSelector;
 import data.DataRecord;
@@ -6,11 +9,16 @@ import data.DataRecord.Type;
 import data.LocalFileCache;
 import geo.GeoPoint;
 
+import java.io.File;
+import java.io.FileInputStream;
 import java.io.PrintStream;
+import java.util.List;
 
 public class Main {
   private final static PrintStream out = System.out;
 
+  private static final String USAGE = "Usage: Main [--quiet] [--data=FILE|-] [QUERIES_FILE]";
+
   final static GeoPoint OKLAHOMA_CITY = new GeoPoint(35.482222f, -97.535f);
 
   final static GeoPoint NEW_YORK = new GeoPoint(40.7127f, -74.0059f);
@@ -25,12 +33,39 @@ public class Main {
   }
 
   public static void main(String[] args) throws Exception {
+    final LocalFileCache cache = new LocalFileCache("/tmp/ghcn_cache");
+
+    // Optional flag that suppresses the per station progress lines.
+    boolean quiet = false;
+    // Optional file of concatenated .dly files to stream the data from, or "-" for stdin.
+    String dataStream = null;
+    String queriesFile = null;
+    for (String arg : args) {
+      if (arg.equals("--quiet")) {
+        quiet = true;
+      } else if (arg.startsWith("--data=")) {
+        dataStream = arg.substring("--data=".length());
+      } else if (arg.startsWith("--")) {
+        usageError("Unknown option: " + arg);
+      } else if (queriesFile != null) {
+        usageError("Unexpected argument: " + arg);
+      } else {
+        queriesFile = arg;
+      }
+    }
+    if (dataStream != null && queriesFile == null) {
+      usageError("--data requires a queries file");
+    }
+
+    // With a query specs file argument, run all its queries in a single pass.
+    if (queriesFile != null) {
+      runBatch(cache, new File(queriesFile), dataStream, quiet);
+      return;
+    }
 
     // Loading the charting classes take time so do it it.
     new ChartLoaderTask().start();
 
-    final LocalFileCache cache = new LocalFileCache("/tmp/ghcn_cache");
-
     //final StationSelector stationsSelector = new StationsSelectorByRadius(NEW_YORK, Units.milesToKm(100));
     //final StationSelector stationsSelector = new StationsSelectorByRadius(LOS_ANGELES, Units.milesToKm(100));
     final StationSelector stationsSelector = new StationSelectorUsStates("OK");
@@ -47,12 +82,15 @@ public class Main {
     //final DataAnalyzerOfTAvg dataAnalyzer = new DataAnalyzerOfTAvg();
     final DataAnalyzerOfDataPoints dataAnalyzer = new DataAnalyzerOfDataPoints();
 
-    final DataProcessor processor = new DataProcessor();
-    processor.process(cache, stationsSelector, dataSelector, dataAnalyzer);
+    // Load the station data from the parsed binary files in the cache, when up to date.
+    final DataProcessor processor = new DataProcessor(Runtime.getRuntime().availableProcessors(), true);
+    processor.setQuiet(quiet).process(cache, stationsSelector, dataSelector, dataAnalyzer);
 
-    dataAnalyzer.dumpResults(out);
-    PrintStream fileOut = new PrintStream("output.csv", "UTF-8");
+    final BufferedTextWriter stdOut = new BufferedTextWriter(out);
+    dataAnalyzer.dumpResults(stdOut);
+    stdOut.flush();
 
+    final BufferedTextWriter fileOut = new BufferedTextWriter("output.csv");
     dataAnalyzer.dumpResults(fileOut);
     fileOut.close();
     out.println("Results written to output.csv");
@@ -61,4 +99,43 @@ public class Main {
 
     out.println("Main() done.");
   }
+
+  private static void usageError(String message) {
+    System.err.println(message);
+    System.err.println(USAGE);
+    System.exit(1);
+  }
+
+  /**
+   * Runs the queries of the given specs file (see BatchQueries) and writes the results of
+   * each query to [name].csv.
+   *
+   * @param dataStream optional file of concatenated .dly files, or "-" for stdin, that is
+   *                   processed one station at a time (see DataProcessor.processStream()).
+   *                   If null, the station files of the cache are used.
+   */
+  private static void runBatch(LocalFileCache cache, File queriesFile, @Nullable String dataStream,
+                               boolean quiet) throws Exception {
+    final List<Query> queries = BatchQueries.parse(queriesFile);
+    out.printf("Running %d queries from %s\n", queries.size(), queriesFile);
+
+    final DataProcessor processor = new DataProcessor(Runtime.getRuntime().availableProcessors(), true);
+    processor.setQuiet(quiet);
+    if (dataStream == null) {
+      processor.processBatch(cache, queries);
+    } else if (dataStream.equals("-")) {
+      processor.processStream(cache, System.in, queries);
+    } else {
+      processor.processStream(cache, new FileInputStream(dataStream), queries);
+    }
+
+    for (Query query : queries) {
+      final String fileName = query.name + ".csv";
+      final BufferedTextWriter fileOut = new BufferedTextWriter(fileName);
+      query.dataAnalyzer.dumpResults(fileOut);
+      fileOut.close();
+      query.dataAnalyzer.writeOutputFiles(query.name);
+      out.printf("Results of %s written to %s\n", query.name, fileName);
+    }
+  }
 }
@@ -18,6 +18,7 @@ public  class StationSelectorUsStates extends DataProcessor.StationSelector {
 
   @Override
   public boolean onStation(StationRecord station) {
-    return stateCodes.contains(station.state);
+    // Stations of other countries, e.g. Canada, have province codes in the state column.
+    return station.id.startsWith("US") && stateCodes.contains(station.state);
   }
 }
@@ -0,0 +1,21 @@
+import data.DataProcessor;
+import data.StationRecord;
+import geo.GeoBox;
+
+public class StationsSelectorByBoundingBox extends DataProcessor.StationSelector {
+  private final GeoBox box;
+
+  public StationsSelectorByBoundingBox(GeoBox box) {
+    this.box = box;
+  }
+
+  @Override
+  public boolean onStation(StationRecord station) {
+    return box.contains(station.geoPoint.lat, station.geoPoint.lon);
+  }
+
+  @Override
+  public GeoBox boundingBox() {
+    return box;
+  }
+}
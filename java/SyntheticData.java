@@ -0,0 +1,113 @@
+import java.io.BufferedWriter;
+import java.io.File;
+import java.io.FileWriter;
+import java.io.IOException;
+import java.io.Writer;
+import java.time.YearMonth;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.Locale;
+import java.util.Random;
+
+/**
+ * Generates deterministic synthetic GHCN files for benchmarking and testing, with no need to
+ * download NOAA data. Writes a ghcnd-stations.txt file and a .dly file per station, in the
+ * layout expected by LocalFileCache.
+ */
+public class SyntheticData {
+
+  private static final String[] STATES = {"CA", "CO", "NY", "OK", "TX", "WA"};
+
+  // GHCN record types that are generated, with their mean and seasonal amplitude in raw
+  // units (tenth of C or tenth of mm).
+  private static final String[] TYPES = {"PRCP", "TMAX", "TMIN"};
+  private static final int[] TYPE_MEAN = {30, 200, 60};
+  private static final int[] TYPE_AMPLITUDE = {20, 120, 100};
+
+  // Fraction of the daily values that are missing.
+  private static final double MISSING_FRACTION = 0.05;
+
+  private final int numStations;
+  private final int firstYear;
+  private final int lastYear;
+  private final long seed;
+
+  public SyntheticData(int numStations, int firstYear, int lastYear, long seed) {
+    this.numStations = numStations;
+    this.firstYear = firstYear;
+    this.lastYear = lastYear;
+    this.seed = seed;
+  }
+
+  /** The id of the station with the given index. */
+  public static String stationId(int stationIndex) {
+    return String.format(Locale.ROOT, "USC%08d", stationIndex);
+  }
+
+  /**
+   * Writes the stations file and the station data files to the given directory.
+   *
+   * @return the ids of the generated stations.
+   */
+  public List<String> write(File dir) throws IOException {
+    final Random random = new Random(seed);
+    final List<String> stationIds = new ArrayList<>();
+    try (Writer writer = new BufferedWriter(new FileWriter(new File(dir, "ghcnd-stations.txt")))) {
+      for (int i = 0; i < numStations; i++) {
+        final String stationId = stationId(i);
+        stationIds.add(stationId);
+        writer.write(stationLine(stationId, random));
+        writer.write('\n');
+      }
+    }
+    for (String stationId : stationIds) {
+      try (Writer writer = new BufferedWriter(new FileWriter(new File(dir, stationId + ".dly")))) {
+        writeStationData(writer, stationId, random);
+      }
+    }
+    return stationIds;
+  }
+
+  /** Returns the number of .dly records that write() generates. */
+  public long numRecords() {
+    return (long) numStations * (lastYear - firstYear + 1) * 12 * TYPES.length;
+  }
+
+  // A line in the fixed width format of ghcnd-stations.txt.
+  private static String stationLine(String stationId, Random random) {
+    final float lat = 25 + random.nextFloat() * 24;
+    final float lon = -124 + random.nextFloat() * 57;
+    final float elevation = random.nextFloat() * 3000;
+    final String state = STATES[random.nextInt(STATES.length)];
+    return String.format(Locale.ROOT, "%-11s %8.4f %9.4f %6.1f %-2s %-30s %3s %3s %5s",
+        stationId, lat, lon, elevation, state, "SYNTHETIC " + stationId, "", "", "");
+  }
+
+  // Writes the .dly lines of a station: per year and month, a line per type.
+  private void writeStationData(Writer writer, String stationId, Random random) throws IOException {
+    final StringBuilder line = new StringBuilder(270);
+    for (int year = firstYear; year <= lastYear; year++) {
+      for (int month = 1; month <= 12; month++) {
+        final int daysInMonth = YearMonth.of(year, month).lengthOfMonth();
+        // Seasonal factor, -1 in January to +1 in July.
+        final double season = -Math.cos((month - 1) * Math.PI / 6);
+        for (int type = 0; type < TYPES.length; type++) {
+          line.setLength(0);
+          line.append(stationId).append(year).append(String.format(Locale.ROOT, "%02d", month)).append(TYPES[type]);
+          for (int day = 1; day <= 31; day++) {
+            int value = -9999;
+            if (day <= daysInMonth && random.nextDouble() >= MISSING_FRACTION) {
+              value = (int) Math.round(TYPE_MEAN[type] + TYPE_AMPLITUDE[type] * season
+                  + random.nextGaussian() * TYPE_AMPLITUDE[type] / 3);
+              if (TYPES[type].equals("PRCP")) {
+                value = Math.max(0, value);
+              }
+            }
+            line.append(String.format(Locale.ROOT, "%5d", value)).append(value == -9999 ? "   " : "  S");
+          }
+          writer.append(line).append('\n');
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,129 @@
+package data;
+
+import java.io.Closeable;
+import java.io.FileOutputStream;
+import java.io.Flushable;
+import java.io.IOException;
+import java.io.OutputStream;
+import java.io.UncheckedIOException;
+
+/**
+ * A buffered writer of ASCII text such as CSV and KML files, with allocation free
+ * formatting of numbers. Output is written to the underlying stream only when the buffer is
+ * full, on flush() and on close(), rather than per line as with a PrintStream.
+ *
+ * <p>Not thread safe. I/O errors are thrown as UncheckedIOException so calls can be chained.</p>
+ */
+public class BufferedTextWriter implements Appendable, Flushable, Closeable {
+  private static final int BUFFER_SIZE = 64 * 1024;
+
+  private final OutputStream out;
+  private final byte[] buffer = new byte[BUFFER_SIZE];
+  private int count;
+
+  // Scratch space for number formatting.
+  private final StringBuilder scratch = new StringBuilder(32);
+
+  public BufferedTextWriter(OutputStream out) {
+    this.out = out;
+  }
+
+  /** Creates a writer of a new file with the given name. */
+  public BufferedTextWriter(String fileName) throws IOException {
+    this(new FileOutputStream(fileName));
+  }
+
+  @Override
+  public BufferedTextWriter append(char c) {
+    if (count == buffer.length) {
+      flushBuffer();
+    }
+    // Non ASCII chars are not expected in the output and are replaced.
+    buffer[count++] = (byte) (c < 0x80 ? c : '?');
+    return this;
+  }
+
+  @Override
+  public BufferedTextWriter append(CharSequence text) {
+    return append(text, 0, text.length());
+  }
+
+  @Override
+  public BufferedTextWriter append(CharSequence text, int start, int end) {
+    for (int i = start; i < end; i++) {
+      append(text.charAt(i));
+    }
+    return this;
+  }
+
+  public BufferedTextWriter append(long value) {
+    scratch.setLength(0);
+    return append(scratch.append(value));
+  }
+
+  /** Appends the value right aligned in a field of the given width, same as "%Nd". */
+  public BufferedTextWriter appendPadded(long value, int width) {
+    scratch.setLength(0);
+    scratch.append(value);
+    return pad(width).append(scratch);
+  }
+
+  /** Appends the value with the given number of decimal places, same as "%.Nf". */
+  public BufferedTextWriter appendFixed(double value, int decimals) {
+    return appendFixed(value, decimals, 0);
+  }
+
+  /**
+   * Appends the value with the given number of decimal places, right aligned in a field of
+   * the given width, same as "%W.Nf".
+   */
+  public BufferedTextWriter appendFixed(double value, int decimals, int width) {
+    scratch.setLength(0);
+    Decimals.appendFixed(scratch, value, decimals);
+    return pad(width).append(scratch);
+  }
+
+  /** Appends a '\n' line terminator. Doesn't flush. */
+  public BufferedTextWriter newLine() {
+    return append('\n');
+  }
+
+  // Appends the spaces that right align the scratch text in the given width.
+  private BufferedTextWriter pad(int width) {
+    for (int i = scratch.length(); i < width; i++) {
+      append(' ');
+    }
+    return this;
+  }
+
+  private void flushBuffer() {
+    try {
+      out.write(buffer, 0, count);
+    } catch (IOException e) {
+      throw new UncheckedIOException(e);
+    }
+    count = 0;
+  }
+
+  /** Writes the buffered text to the underlying stream and flushes it. */
+  @Override
+  public void flush() {
+    flushBuffer();
+    try {
+      out.flush();
+    } catch (IOException e) {
+      throw new UncheckedIOException(e);
+    }
+  }
+
+  /** Flushes and closes the underlying stream. */
+  @Override
+  public void close() {
+    flush();
+    try {
+      out.close();
+    } catch (IOException e) {
+      throw new UncheckedIOException(e);
+    }
+  }
+}
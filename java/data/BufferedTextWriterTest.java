@@ -0,0 +1,22 @@
+package data;
+
+import org.junit.Test;
+
+import java.io.ByteArrayOutputStream;
+
+import static org.junit.Assert.*;
+
+public class BufferedTextWriterTest {
+
+  @Test
+  public void testFormatting() {
+    final ByteArrayOutputStream bytes = new ByteArrayOutputStream();
+    final BufferedTextWriter writer = new BufferedTextWriter(bytes);
+    writer.appendPadded(1950, 6).append(',').appendFixed(-3.14159, 2, 7).append(',')
+        .appendFixed(12.5, 1).append(',').append(-42).newLine();
+    // Nothing is written before the flush.
+    assertEquals(0, bytes.size());
+    writer.flush();
+    assertEquals(String.format("%6d,%7.2f,%.1f,%d\n", 1950, -3.14159, 12.5, -42), bytes.toString());
+  }
+}
@@ -0,0 +1,53 @@
+package data;
+
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
+
+/**
+ * A reusable CharSequence view of a single ASCII text line inside a byte buffer. Allows
+ * parsing lines in place without copying them into Strings. The view is valid only until
+ * it's reset to the next line.
+ */
+class ByteLineView implements CharSequence {
+  private ByteBuffer buffer;
+  private int start;
+  private int length;
+
+  /** Points this view at bytes [start, start + length) of the buffer. */
+  void set(ByteBuffer buffer, int start, int length) {
+    this.buffer = buffer;
+    this.start = start;
+    this.length = length;
+  }
+
+  @Override
+  public int length() {
+    return length;
+  }
+
+  @Override
+  public char charAt(int index) {
+    if (index < 0 || index >= length) {
+      throw new IndexOutOfBoundsException("Index " + index + ", length " + length);
+    }
+    return (char) (buffer.get(start + index) & 0xff);
+  }
+
+  /** Returns a copy of the given range as a String. */
+  @Override
+  public CharSequence subSequence(int begin, int end) {
+    if (begin < 0 || end > length || begin > end) {
+      throw new IndexOutOfBoundsException("Range [" + begin + ", " + end + "), length " + length);
+    }
+    final byte[] bytes = new byte[end - begin];
+    for (int i = 0; i < bytes.length; i++) {
+      bytes[i] = buffer.get(start + begin + i);
+    }
+    return new String(bytes, StandardCharsets.ISO_8859_1);
+  }
+
+  @Override
+  public String toString() {
+    return subSequence(0, length).toString();
+  }
+}
@@ -0,0 +1,119 @@
+package data;
+
+/**
+ * Tracks the record (highest or lowest) value of each day of the year of a station, with
+ * the year it was first set and the years that tied it. The state of the 366 days is kept
+ * in flat arrays, with a few tie years inline per day, so update() is O(1) and allocation
+ * free.
+ *
+ * <p>reset() is O(1) too, the days are invalidated with a generation counter, so a single
+ * instance can be reused for all the stations analyzed by a thread.</p>
+ */
+public class DailyRecordTracker {
+  // Number of days of year slots. Feb 29 has its own slot.
+  public static final int DAYS_OF_YEAR = 366;
+  // Max number of tie years stored per day. tieCount() counts all the ties.
+  public static final int INLINE_TIES = 4;
+
+  // Return values of update().
+  // The value is not a record.
+  public static final int NONE = 0;
+  // The first value of the day since reset().
+  public static final int FIRST = 1;
+  // The value breaks the day's record.
+  public static final int NEW_RECORD = 2;
+  // The value ties the day's record.
+  public static final int TIE = 3;
+
+  // Index of the first day of each month (1 based) in a leap year.
+  private static final int[] MONTH_FIRST_SLOT =
+      {0, 0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335};
+
+  // If true, tracks the highest values, otherwise the lowest.
+  private final boolean highs;
+
+  // Per day state. Valid only if generations[day] == generation.
+  private final int[] generations = new int[DAYS_OF_YEAR];
+  private final int[] values = new int[DAYS_OF_YEAR];
+  private final int[] firstYears = new int[DAYS_OF_YEAR];
+  private final int[] tieCounts = new int[DAYS_OF_YEAR];
+  // The tie years of day d are in [d * INLINE_TIES, d * INLINE_TIES + min(tieCount, INLINE_TIES)).
+  private final int[] tieYears = new int[DAYS_OF_YEAR * INLINE_TIES];
+
+  // Starts at 1 so the zero initialized days are invalid.
+  private int generation = 1;
+
+  /** @param highs true to track the highest values, false to track the lowest. */
+  public DailyRecordTracker(boolean highs) {
+    this.highs = highs;
+  }
+
+  /** The day of year slot of the given month (1 based) and day (1 based). */
+  public static int dayOfYear(int month, int day) {
+    return MONTH_FIRST_SLOT[month] + day - 1;
+  }
+
+  /** Clears the records of all the days. */
+  public void reset() {
+    generation++;
+  }
+
+  /**
+   * Updates the record of a day with a value of the given year. The values of a day must be
+   * passed in increasing year order.
+   *
+   * @return NONE, FIRST, NEW_RECORD or TIE.
+   */
+  public int update(int dayOfYear, int year, int rawValue) {
+    if (generations[dayOfYear] != generation) {
+      generations[dayOfYear] = generation;
+      setRecord(dayOfYear, year, rawValue);
+      return FIRST;
+    }
+    final int record = values[dayOfYear];
+    if (highs ? rawValue > record : rawValue < record) {
+      setRecord(dayOfYear, year, rawValue);
+      return NEW_RECORD;
+    }
+    if (rawValue != record) {
+      return NONE;
+    }
+    final int tieCount = tieCounts[dayOfYear];
+    if (tieCount < INLINE_TIES) {
+      tieYears[dayOfYear * INLINE_TIES + tieCount] = year;
+    }
+    tieCounts[dayOfYear] = tieCount + 1;
+    return TIE;
+  }
+
+  private void setRecord(int dayOfYear, int year, int rawValue) {
+    values[dayOfYear] = rawValue;
+    firstYears[dayOfYear] = year;
+    tieCounts[dayOfYear] = 0;
+  }
+
+  /** Returns true if the day had a value since the last reset(). */
+  public boolean hasRecord(int dayOfYear) {
+    return generations[dayOfYear] == generation;
+  }
+
+  /** The record raw value of the day. Call only if hasRecord(dayOfYear). */
+  public int recordValue(int dayOfYear) {
+    return values[dayOfYear];
+  }
+
+  /** The year the record of the day was first set. Call only if hasRecord(dayOfYear). */
+  public int firstYear(int dayOfYear) {
+    return firstYears[dayOfYear];
+  }
+
+  /** Number of later years that tied the record. Call only if hasRecord(dayOfYear). */
+  public int tieCount(int dayOfYear) {
+    return tieCounts[dayOfYear];
+  }
+
+  /** The i-th tie year of the day, for i < min(tieCount(dayOfYear), INLINE_TIES). */
+  public int tieYear(int dayOfYear, int i) {
+    return tieYears[dayOfYear * INLINE_TIES + i];
+  }
+}
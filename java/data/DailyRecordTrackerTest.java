@@ -0,0 +1,49 @@
+package data;
+
+import org.junit.Test;
+
+import static data.DailyRecordTracker.*;
+import static org.junit.Assert.*;
+
+public class DailyRecordTrackerTest {
+
+  @Test
+  public void testDayOfYear() {
+    assertEquals(0, DailyRecordTracker.dayOfYear(1, 1));
+    assertEquals(59, DailyRecordTracker.dayOfYear(2, 29));
+    assertEquals(60, DailyRecordTracker.dayOfYear(3, 1));
+    assertEquals(365, DailyRecordTracker.dayOfYear(12, 31));
+  }
+
+  @Test
+  public void testHighs() {
+    final DailyRecordTracker tracker = new DailyRecordTracker(true);
+    final int day = DailyRecordTracker.dayOfYear(7, 4);
+    assertFalse(tracker.hasRecord(day));
+    assertEquals(FIRST, tracker.update(day, 1950, 300));
+    assertEquals(NONE, tracker.update(day, 1951, 250));
+    assertEquals(NEW_RECORD, tracker.update(day, 1952, 310));
+    for (int year = 1953; year < 1959; year++) {
+      assertEquals(TIE, tracker.update(day, year, 310));
+    }
+    assertEquals(310, tracker.recordValue(day));
+    assertEquals(1952, tracker.firstYear(day));
+    assertEquals(6, tracker.tieCount(day));
+    assertEquals(1953, tracker.tieYear(day, 0));
+    assertEquals(1956, tracker.tieYear(day, INLINE_TIES - 1));
+
+    tracker.reset();
+    assertFalse(tracker.hasRecord(day));
+    assertEquals(FIRST, tracker.update(day, 2000, 100));
+    assertEquals(0, tracker.tieCount(day));
+  }
+
+  @Test
+  public void testLows() {
+    final DailyRecordTracker tracker = new DailyRecordTracker(false);
+    assertEquals(FIRST, tracker.update(0, 1950, -50));
+    assertEquals(NEW_RECORD, tracker.update(0, 1951, -60));
+    assertEquals(NONE, tracker.update(0, 1952, -10));
+    assertEquals(-60, tracker.recordValue(0));
+  }
+}
@@ -1,9 +1,9 @@
 package data;
 
-import java.util.ArrayList;
-import java.util.Collections;
-import java.util.List;
-import java.util.Set;
+import com.sun.istack.internal.Nullable;
+
+import java.io.IOException;
+
 
 /**
  * Base class for user provided object that performs the necesary data analysis, typically in a form
@@ -30,21 +30,38 @@ public class DataAnalyzer {
   }
 
   /**
-   * Given a set of years, return a sorted array with all the years between the min and max
-   * years in the set. Useful to generate annual analysis results from aggregated data in a Map.
+   * Returns a new analyzer of the same kind and configuration as this one, with no data, or
+   * null if this analyzer doesn't support partial analysis (the default).
+   *
+   * <p>When supported, the DataProcessor analyzes each station with its own partial analyzer
+   * on one of its threads, and then merges the partial analyzers into this one with
+   * mergePartialAnalyzer(), in the stations order. Must be thread safe. To keep the results
+   * independent of the number of threads, mergePartialAnalyzer() should be exact, e.g. sum
+   * raw int values rather than floats.</p>
+   */
+  @Nullable
+  public DataAnalyzer newPartialAnalyzer() {
+    return null;
+  }
+
+  /**
+   * Adds the results of a partial analyzer returned by newPartialAnalyzer() to this analyzer.
+   */
+  public void mergePartialAnalyzer(DataAnalyzer partialAnalyzer) {
+    throw new UnsupportedOperationException("Partial analysis is not supported");
+  }
+
+  /**
+   * Writes the analysis results, typically as CSV text. Called once all the stations were
+   * processed.
+   */
+  public void dumpResults(BufferedTextWriter writer) {
+  }
+
+  /**
+   * Writes analysis results that don't fit dumpResults(), such as binary or KML files, named
+   * [baseName].[extension]. Called once all the stations were processed. No-op by default.
    */
-  protected int[] computeYearRange(Set<Integer> yearsSet) {
-    if (yearsSet.isEmpty()) {
-      return new int[0];
-    }
-    final List<Integer> sortedYears = new ArrayList(yearsSet);
-    Collections.sort(sortedYears);
-    final int minYear = sortedYears.get(0);
-    final int maxYear = sortedYears.get(sortedYears.size() - 1);
-    final int[] result = new int[maxYear - minYear + 1];
-    for (int i = 0; i < result.length; i++) {
-      result[i] = minYear + i;
-    }
-    return result;
+  public void writeOutputFiles(String baseName) throws IOException {
   }
 }
@@ -3,30 +3,92 @@ package data;
 import com.sun.istack.internal.Nullable;
 
 import java.io.*;
+import java.nio.ByteBuffer;
+import java.nio.channels.FileChannel;
+import java.nio.file.StandardOpenOption;
 
 /** A reader for GHCN's station data files. It reads the .dly file and
- * provides the records as DataRecord instances. */
+ * provides the records as DataRecord instances.
+ *
+ * <p>Regular files are memory mapped and their lines are parsed in place. Other inputs,
+ * such as pipes or stdin, are read through a chunk buffer that is refilled as needed.</p>
+ */
 public class DataFileReader {
 
+  // Initial size of the chunk buffer used in stream mode. Grows if a line doesn't fit.
+  private static final int STREAM_BUFFER_SIZE = 64 * 1024;
+
+  // The initial chunk buffer size of this reader.
+  private final int streamBufferSize;
+
+  // The bytes of the file (mapped mode) or the current chunk of the stream (stream mode).
   @Nullable
-  private BufferedReader reader;
+  private ByteBuffer buffer;
 
-  // Current text line.
+  // Non null in stream mode.
   @Nullable
-  private String textLine;
+  private InputStream stream;
+
+  // Index in buffer of the first byte that was not consumed yet.
+  private int position;
 
+  // Current text line. A view into buffer.
+  private final ByteLineView textLine = new ByteLineView();
+
+  public DataFileReader() {
+    this(STREAM_BUFFER_SIZE);
+  }
+
+  // For tests, to exercise the refills and growth of the chunk buffer with short inputs.
+  DataFileReader(int streamBufferSize) {
+    this.streamBufferSize = streamBufferSize;
+  }
 
   /** Open on given .dly file. */
-  public  DataFileReader open(File file) throws FileNotFoundException {
-    reader = new BufferedReader(new FileReader(file));
+  public  DataFileReader open(File file) throws IOException {
+    if (!file.isFile() || file.length() > Integer.MAX_VALUE) {
+      return open(new FileInputStream(file));
+    }
+    try (FileChannel channel = FileChannel.open(file.toPath(), StandardOpenOption.READ)) {
+      // The mapping stays valid after the channel is closed.
+      buffer = channel.map(FileChannel.MapMode.READ_ONLY, 0, channel.size());
+    }
+    stream = null;
+    position = 0;
+    return this;
+  }
+
+  /**
+   * Open on the byte range [begin, end) of a file with the concatenated .dly files of many
+   * stations. Only that range is mapped. See DlyFileIndex.
+   */
+  public DataFileReader open(File file, long begin, long end) throws IOException {
+    if (begin < 0 || end < begin || end - begin > Integer.MAX_VALUE) {
+      throw new IllegalArgumentException("Invalid range [" + begin + ", " + end + ") of " + file);
+    }
+    try (FileChannel channel = FileChannel.open(file.toPath(), StandardOpenOption.READ)) {
+      buffer = channel.map(FileChannel.MapMode.READ_ONLY, begin, end - begin);
+    }
+    stream = null;
+    position = 0;
+    return this;
+  }
+
+  /** Open on a stream of .dly text lines, such as a pipe. Takes ownership of the stream. */
+  public DataFileReader open(InputStream inputStream) {
+    stream = inputStream;
+    buffer = ByteBuffer.wrap(new byte[streamBufferSize]);
+    buffer.limit(0);
+    position = 0;
     return this;
   }
 
   /** Close. Call before discarding the reader. */
   public void close() throws IOException {
-    if (reader != null) {
-      textLine = null;
-      reader.close();
+    buffer = null;
+    if (stream != null) {
+      stream.close();
+      stream = null;
     }
   }
 
@@ -37,9 +99,8 @@ public class DataFileReader {
    */
   public boolean readNext() throws IOException {
     for (; ; ) {
-      textLine = reader.readLine();
       // End of file
-      if (textLine == null) {
+      if (!nextLine()) {
         return false;
       }
       // Apply filter
@@ -51,10 +112,84 @@ public class DataFileReader {
     }
   }
 
+  /**
+   * Returns the packed station id of the current line (see StationRegistry.packStationId()),
+   * without parsing the rest of the line.
+   */
+  public long stationKey() {
+    return StationRegistry.packStationId(textLine, 0);
+  }
+
+  // The current line, without its line terminator. For tests.
+  CharSequence textLine() {
+    return textLine;
+  }
+
   /**
    * Parses the current line and return as a new RecordData instance.
    */
   public DataRecord parseTextLine() {
     return DataRecord.parseFromTextLine(textLine);
   }
+
+  // Points textLine at the next line, without its line terminator. Returns false if
+  // at end of file.
+  private boolean nextLine() throws IOException {
+    int scanFrom = position;
+    int end;
+    while ((end = indexOfNewLine(scanFrom)) < 0) {
+      scanFrom = buffer.limit();
+      final int consumed = position;
+      if (!fillBuffer()) {
+        break;
+      }
+      scanFrom -= consumed;
+    }
+
+    final int limit = buffer.limit();
+    if (end < 0) {
+      // Last line may not be terminated.
+      if (position >= limit) {
+        return false;
+      }
+      end = limit;
+    }
+
+    int lineEnd = end;
+    if (lineEnd > position && buffer.get(lineEnd - 1) == '\r') {
+      lineEnd--;
+    }
+    textLine.set(buffer, position, lineEnd - position);
+    position = Math.min(end + 1, limit);
+    return true;
+  }
+
+  private int indexOfNewLine(int from) {
+    final int limit = buffer.limit();
+    for (int i = from; i < limit; i++) {
+      if (buffer.get(i) == '\n') {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  // Stream mode only. Moves the unconsumed bytes to the beginning of the buffer and reads
+  // more bytes after them. Returns false if no more bytes are available.
+  private boolean fillBuffer() throws IOException {
+    if (stream == null) {
+      return false;
+    }
+    final byte[] bytes = buffer.array();
+    final int remaining = buffer.limit() - position;
+    final byte[] target = (remaining == bytes.length) ? new byte[bytes.length * 2] : bytes;
+    System.arraycopy(bytes, position, target, 0, remaining);
+    final int count = stream.read(target, remaining, target.length - remaining);
+    if (target != bytes) {
+      buffer = ByteBuffer.wrap(target);
+    }
+    buffer.limit(remaining + Math.max(count, 0));
+    position = 0;
+    return count > 0;
+  }
 }
@@ -0,0 +1,136 @@
+package data;
+
+import org.junit.Test;
+
+import java.io.ByteArrayInputStream;
+import java.io.File;
+import java.io.FileOutputStream;
+import java.io.IOException;
+import java.io.InputStream;
+import java.nio.charset.StandardCharsets;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+
+import static data.TestData.textLine;
+import static org.junit.Assert.*;
+
+public class DataFileReaderTest {
+
+  private static final String LINE1 = textLine("USC00000001", 1, "TMAX", 10);
+  private static final String LINE2 = textLine("USC00000001", 2, "TMIN", 20);
+  private static final String LINE3 = textLine("USC00000002", 3, "PRCP", 30);
+
+  // A stream that returns at most maxRead bytes per read, like a pipe.
+  private static InputStream trickle(byte[] bytes, int maxRead) {
+    return new ByteArrayInputStream(bytes) {
+      @Override
+      public synchronized int read(byte[] b, int off, int len) {
+        return super.read(b, off, Math.min(len, maxRead));
+      }
+    };
+  }
+
+  // Returns the accepted lines of the reader.
+  private static List<String> readLines(DataFileReader reader) throws IOException {
+    final List<String> result = new ArrayList<>();
+    while (reader.readNext()) {
+      result.add(reader.textLine().toString());
+    }
+    reader.close();
+    return result;
+  }
+
+  // Returns the accepted lines of the given text, read from a memory mapped file.
+  private static List<String> readMapped(String text) throws IOException {
+    final File file = File.createTempFile("test", ".dly");
+    file.deleteOnExit();
+    try (FileOutputStream out = new FileOutputStream(file)) {
+      out.write(text.getBytes(StandardCharsets.ISO_8859_1));
+    }
+    return readLines(new DataFileReader().open(file));
+  }
+
+  // Returns the accepted lines of the given text, read from a stream with the given initial
+  // buffer size and max bytes per read.
+  private static List<String> readStream(String text, int bufferSize, int maxRead) throws IOException {
+    final byte[] bytes = text.getBytes(StandardCharsets.ISO_8859_1);
+    return readLines(new DataFileReader(bufferSize).open(trickle(bytes, maxRead)));
+  }
+
+  // Asserts that the given text is read as the expected lines in all the modes.
+  private static void assertLines(String text, String... expected) throws IOException {
+    final List<String> expectedLines = Arrays.asList(expected);
+    assertEquals(expectedLines, readMapped(text));
+    assertEquals(expectedLines, readStream(text, 64 * 1024, Integer.MAX_VALUE));
+    assertEquals(expectedLines, readStream(text, 64 * 1024, 7));
+  }
+
+  @Test
+  public void testLineEndings() throws Exception {
+    assertLines("");
+    assertLines(LINE1 + "\n" + LINE2 + "\n", LINE1, LINE2);
+    assertLines(LINE1 + "\r\n" + LINE2 + "\r\n", LINE1, LINE2);
+    assertLines(LINE1 + "\r\n" + LINE2 + "\n" + LINE3 + "\r\n", LINE1, LINE2, LINE3);
+  }
+
+  @Test
+  public void testLastLineWithoutNewLine() throws Exception {
+    assertLines(LINE1 + "\n" + LINE2, LINE1, LINE2);
+    assertLines(LINE1 + "\r\n" + LINE2 + "\r", LINE1, LINE2);
+    assertLines(LINE1, LINE1);
+  }
+
+  @Test
+  public void testRejectedLinesAreSkipped() throws Exception {
+    assertLines("\n" + LINE1 + "\n\r\nshort line\n" + LINE2 + "\n", LINE1, LINE2);
+  }
+
+  @Test
+  public void testLineLongerThanBuffer() throws Exception {
+    final char[] padding = new char[100 * 1024];
+    Arrays.fill(padding, ' ');
+    final String longLine = LINE1 + new String(padding);
+    final String text = longLine + "\r\n" + LINE2 + "\n" + longLine;
+    assertLines(text, longLine, LINE2, longLine);
+    // Buffers that are much shorter than the lines grow several times.
+    assertEquals(Arrays.asList(longLine, LINE2, longLine), readStream(text, 1, Integer.MAX_VALUE));
+    assertEquals(Arrays.asList(longLine, LINE2, longLine), readStream(text, 16, 100));
+  }
+
+  @Test
+  public void testRefillAcrossBufferBoundary() throws Exception {
+    final String text = LINE1 + "\r\n" + LINE2 + "\n" + LINE3 + "\r\n" + LINE1 + "\n" + LINE2;
+    final List<String> expected = Arrays.asList(LINE1, LINE2, LINE3, LINE1, LINE2);
+    // Buffer sizes around the line length, so that the line terminators, including the
+    // "\r\n" pairs, fall at all the positions relative to the refills.
+    for (int bufferSize = LINE1.length() - 2; bufferSize <= LINE1.length() + 4; bufferSize++) {
+      assertEquals("buffer size " + bufferSize, expected, readStream(text, bufferSize, Integer.MAX_VALUE));
+      for (int maxRead = 1; maxRead <= 5; maxRead++) {
+        assertEquals("buffer size " + bufferSize + ", max read " + maxRead,
+            expected, readStream(text, bufferSize, maxRead));
+      }
+    }
+    assertEquals(expected, readStream(text, 400, 300));
+  }
+
+  @Test
+  public void testParseTextLine() throws Exception {
+    final DataFileReader reader = new DataFileReader(16).open(trickle(
+        (LINE1 + "\r\n" + LINE3).getBytes(StandardCharsets.ISO_8859_1), 50));
+    assertTrue(reader.readNext());
+    assertEquals(StationRegistry.packStationId("USC00000001", 0), reader.stationKey());
+    DataRecord data = reader.parseTextLine();
+    assertEquals(1950, data.year);
+    assertEquals(1, data.month);
+    assertEquals(DataRecord.Type.TMAX, data.type);
+    assertEquals(10, data.rawValues[0]);
+    assertEquals(DataRecord.MISSING_VALUE, data.rawValues[DataRecord.MAX_DAYS_IN_MONTH - 1]);
+    assertTrue(reader.readNext());
+    data = reader.parseTextLine();
+    assertEquals(DataRecord.Type.PRCP, data.type);
+    assertEquals(30, data.rawValues[0]);
+    assertFalse(reader.readNext());
+    reader.close();
+  }
+}
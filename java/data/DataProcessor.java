@@ -1,8 +1,21 @@
 package data;
 
+import com.sun.istack.internal.Nullable;
+import geo.GeoBox;
+
+import java.io.InputStream;
 import java.io.PrintStream;
+import java.util.ArrayDeque;
 import java.util.ArrayList;
+import java.util.BitSet;
+import java.util.Collections;
+import java.util.Deque;
+import java.util.HashMap;
 import java.util.List;
+import java.util.Map;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
 
 /**
  * A framework class that orchestrates the analysis sessions of GHCN data.
@@ -11,6 +24,49 @@ public class DataProcessor {
 
   private final static PrintStream out = System.out;
 
+  // Max number of parsed stations waiting for the analyzer, per parser thread. Bounds the
+  // memory used by stations that were parsed ahead.
+  private static final int PENDING_STATIONS_PER_THREAD = 4;
+
+  // Number of threads used to parse the station data files.
+  private final int numThreads;
+
+  // If true, station data is loaded from the binary series files in the cache rather
+  // than parsed from the .dly text files.
+  private final boolean useSeriesCache;
+
+  // If true, the per station progress lines are not printed.
+  private boolean quiet;
+
+  /** Creates a processor that parses station data files using all the available cores. */
+  public DataProcessor() {
+    this(Runtime.getRuntime().availableProcessors(), false);
+  }
+
+  /**
+   * Creates a processor that parses station data files using the given number of threads.
+   *
+   * @param useSeriesCache if true, the data of each station is loaded from a binary series
+   *                       file in the cache, which is created on first use and recreated
+   *                       when the station's .dly file changes. See StationSeriesFile.
+   */
+  public DataProcessor(int numThreads, boolean useSeriesCache) {
+    if (numThreads < 1) {
+      throw new IllegalArgumentException("Invalid number of threads: " + numThreads);
+    }
+    this.numThreads = numThreads;
+    this.useSeriesCache = useSeriesCache;
+  }
+
+  /**
+   * Suppresses the per station progress lines, which on large selections can take more time
+   * than the analysis. Returns this processor.
+   */
+  public DataProcessor setQuiet(boolean quiet) {
+    this.quiet = quiet;
+    return this;
+  }
+
   /**
    * User provided filtering of stations. Only stations for which this returns true are
    * included in the analsys. Useful to restrict the analysis to a region or another
@@ -18,16 +74,68 @@ public class DataProcessor {
    */
   public static abstract class StationSelector {
     public abstract boolean onStation(StationRecord station);
+
+    /**
+     * Optional bounding box of the selected stations. Stations outside of it are rejected
+     * without calling onStation(). If all the selectors of a batch have a box, only the
+     * stations in the boxes are visited, using a spatial index of the stations.
+     */
+    @Nullable
+    public GeoBox boundingBox() {
+      return null;
+    }
   }
 
   /**
    * User provided filtering of station data records. Only data records for which this returns
    * true are sent to the DataAnalyzer.
+   *
+   * <p>Called concurrently from the parser threads so implementations must be thread safe.</p>
    */
   public static abstract class DataSelector {
     public abstract boolean onDataRecord(DataRecord data);
   }
 
+  /**
+   * A single analysis of a batch. Its analyzer is called with the stations and data records
+   * that pass its own station and data selectors.
+   */
+  public static class Query {
+    // User provided name. Used for logging and for naming the query results.
+    public final String name;
+    public final StationSelector stationSelector;
+    public final DataSelector dataSelector;
+    public final DataAnalyzer dataAnalyzer;
+
+    public Query(String name, StationSelector stationSelector, DataSelector dataSelector,
+                 DataAnalyzer dataAnalyzer) {
+      this.name = name;
+      this.stationSelector = stationSelector;
+      this.dataSelector = dataSelector;
+      this.dataAnalyzer = dataAnalyzer;
+    }
+  }
+
+  // A station that was selected by one or more of the queries.
+  static class SelectedStation {
+    final StationRecord station;
+    final List<Query> queries = new ArrayList<>();
+
+    SelectedStation(StationRecord station) {
+      this.station = station;
+    }
+
+    // Returns true if any of the station's queries selects this data record.
+    boolean isSelected(DataRecord data) {
+      for (Query query : queries) {
+        if (query.dataSelector.onDataRecord(data)) {
+          return true;
+        }
+      }
+      return false;
+    }
+  }
+
   /**
    * This is the main method of the data processor. It performs the filtering and analysis based
    * on the user's filters and analyser passed to it.
@@ -40,56 +148,307 @@ public class DataProcessor {
    */
   public void process(LocalFileCache cache, StationSelector stationSelector, DataSelector
       dataSelector, DataAnalyzer dataAnalyzer) throws Exception {
-    final List<StationRecord> selectedStations = selectStations(cache, stationSelector);
-    processData(cache, selectedStations, dataSelector, dataAnalyzer);
+    processBatch(cache, Collections.singletonList(
+        new Query("", stationSelector, dataSelector, dataAnalyzer)));
+  }
+
+  /**
+   * Same as process() but performs several analyses in a single pass. The stations file and
+   * the data of each station are read once and shared by all the queries that select them.
+   * Each analyzer sees the same calls it would see if its query was processed alone.
+   */
+  public void processBatch(LocalFileCache cache, List<Query> queries) throws Exception {
+    final List<SelectedStation> selectedStations = selectStations(cache, queries);
+    processData(cache, selectedStations);
   }
 
   /**
-   * Reads the station records from the station file and performs the station filtering.  If the
-   * station file is not available, it is fetched and cached locally.
+   * Same as processBatch() but reads the data of all the stations from a single stream of
+   * concatenated .dly files, such as the extracted ghcnd_all.tar.gz piped to stdin, rather
+   * than from per station files in the cache. The cache is used only for the stations file.
+   *
+   * <p>Stations are analyzed as soon as their last line is read, in the order of the
+   * stream, and their data is then released. Memory use is bounded by a few stations per
+   * thread regardless of the size of the stream. The lines of each station must be
+   * contiguous; lines of a station that was already analyzed are ignored. Lines of stations
+   * that are not selected are skipped without parsing.</p>
    */
-  private List<StationRecord> selectStations(LocalFileCache cache, StationSelector
-      stationSelector) throws Exception {
+  public void processStream(LocalFileCache cache, InputStream dataStream, List<Query> queries)
+      throws Exception {
+    final Map<Long, SelectedStation> selectedStations = new HashMap<>();
+    for (SelectedStation selectedStation : selectStations(cache, queries)) {
+      selectedStations.put(StationRegistry.packStationId(selectedStation.station.id, 0), selectedStation);
+    }
+
+    final ExecutorService executor = Executors.newFixedThreadPool(numThreads);
+    final DataFileReader reader = new DataFileReader().open(dataStream);
+    try {
+      final int maxPending = numThreads * PENDING_STATIONS_PER_THREAD;
+      final Deque<SelectedStation> pendingStations = new ArrayDeque<>();
+      final Deque<Future<StationResult>> pending = new ArrayDeque<>();
+      long currentKey = -1;
+      SelectedStation currentStation = null;
+      List<DataRecord> currentRecords = new ArrayList<>();
+      for (boolean hasNext = reader.readNext(); ; hasNext = reader.readNext()) {
+        final long key = hasNext ? reader.stationKey() : -1;
+        if (key != currentKey || !hasNext) {
+          // The current station is complete.
+          if (currentStation != null) {
+            final SelectedStation station = currentStation;
+            final List<DataRecord> records = currentRecords;
+            pendingStations.add(station);
+            pending.add(executor.submit(() -> analyzeRecords(station, records)));
+            if (pending.size() >= maxPending) {
+              onStationResult(pendingStations.remove(), pending.remove().get());
+            }
+          }
+          if (!hasNext) {
+            break;
+          }
+          currentKey = key;
+          // Removed so a station is analyzed at most once.
+          currentStation = selectedStations.remove(key);
+          currentRecords = new ArrayList<>();
+        }
+        if (currentStation == null) {
+          continue;
+        }
+        final DataRecord data = reader.parseTextLine();
+        if (currentStation.isSelected(data)) {
+          currentRecords.add(data);
+        }
+      }
+      while (!pending.isEmpty()) {
+        onStationResult(pendingStations.remove(), pending.remove().get());
+      }
+    } finally {
+      reader.close();
+      executor.shutdownNow();
+    }
+  }
+
+  /**
+   * Reads the station records from the station registry and performs the station filtering of all
+   * the queries.  If the station file is not available, it is fetched and cached locally.
+   */
+  private List<SelectedStation> selectStations(LocalFileCache cache, List<Query> queries)
+      throws Exception {
+    return selectStations(cache.loadStationRegistry(), queries);
+  }
+
+  // Performs the station filtering of all the queries over the stations of the registry, of
+  // all countries.
+  static List<SelectedStation> selectStations(StationRegistry registry, List<Query> queries) {
     int stationsCount = 0;
-    cache.cacheStationsListFile();
-    final StationsFileReader stationsReader = new StationsFileReader().open(cache
-        .stationsListLocalFile());
-    final List<StationRecord> result = new ArrayList<>();
-    while (stationsReader.readNext()) {
+    final GeoBox[] boxes = new GeoBox[queries.size()];
+    for (int i = 0; i < boxes.length; i++) {
+      boxes[i] = queries.get(i).stationSelector.boundingBox();
+    }
+    final BitSet candidates = candidateStations(registry, boxes);
+    // Per query, the number of selected stations.
+    final int[] selectedCounts = new int[queries.size()];
+    final List<SelectedStation> result = new ArrayList<>();
+    for (int index = candidates.nextSetBit(0); index >= 0; index = candidates.nextSetBit(index + 1)) {
       stationsCount++;
-      final StationRecord stationRecord = stationsReader.parseTextLine();
-      if (stationSelector.onStation(stationRecord)) {
-        result.add(stationRecord);
+      final StationRecord stationRecord = registry.stationRecord(index);
+      SelectedStation selectedStation = null;
+      for (int i = 0; i < boxes.length; i++) {
+        final Query query = queries.get(i);
+        if (boxes[i] != null
+            && !boxes[i].contains(registry.latitude(index), registry.longitude(index))) {
+          continue;
+        }
+        if (query.stationSelector.onStation(stationRecord)) {
+          selectedCounts[i]++;
+          if (selectedStation == null) {
+            selectedStation = new SelectedStation(stationRecord);
+            result.add(selectedStation);
+          }
+          selectedStation.queries.add(query);
+        }
       }
     }
-    stationsReader.close();
     out.printf("Iterated over %d stations\n", stationsCount);
+    for (int i = 0; i < selectedCounts.length; i++) {
+      if (selectedCounts[i] == 0) {
+        out.printf("Warning: query %s selected no stations\n", queries.get(i).name);
+      }
+    }
+    return result;
+  }
+
+  /**
+   * Returns the indexes of the stations that need to be passed to the station selectors. All
+   * the stations, unless each selector has a bounding box.
+   */
+  private static BitSet candidateStations(StationRegistry registry, GeoBox[] boxes) {
+    final BitSet result = new BitSet(registry.size());
+    for (GeoBox box : boxes) {
+      if (box == null) {
+        result.set(0, registry.size());
+        return result;
+      }
+    }
+    final StationGrid grid = new StationGrid(registry);
+    for (GeoBox box : boxes) {
+      grid.findStations(box, result);
+    }
     return result;
   }
 
+  // The result of loading a station on a parser thread.
+  private static class StationResult {
+    // The data records for the queries that are analyzed on the calling thread. Empty if all
+    // the queries were analyzed on the parser thread.
+    final List<DataRecord> records;
+    // Per query of the station, the partial analyzer that already analyzed the station on
+    // the parser thread, or null if the query is analyzed on the calling thread.
+    final DataAnalyzer[] partialAnalyzers;
+
+    StationResult(List<DataRecord> records, DataAnalyzer[] partialAnalyzers) {
+      this.records = records;
+      this.partialAnalyzers = partialAnalyzers;
+    }
+  }
+
   /**
    * Read the station files that passed filtering, performs the data filtering and pass the data
-   * records to the user provided analyzer.
+   * records to the user provided analyzers.
    * If a station file is not available locally, it is fetched and cached on a local disk.
+   *
+   * <p>The stations are loaded ahead by a pool of threads, one station per task. Analyzers
+   * that support partial analyzers (see DataAnalyzer.newPartialAnalyzer()) analyze each
+   * station on the pool thread and the per station partial results are merged on this
+   * thread. The other analyzers are called on this thread. Either way, stations are handled
+   * on this thread in the order of selectedStations, so the analysis results are
+   * deterministic regardless of the number of threads.</p>
    */
-  private  void processData(LocalFileCache cache, List<StationRecord> stationRecords,
-                                  DataSelector dataSelector, DataAnalyzer dataAnalyzer) throws Exception {
+  private  void processData(LocalFileCache cache, List<SelectedStation> selectedStations)
+      throws Exception {
     // This fetches and caches the missing station files. May take some time.
+    final List<StationRecord> stationRecords = new ArrayList<>();
+    for (SelectedStation selectedStation : selectedStations) {
+      stationRecords.add(selectedStation.station);
+    }
     cache.cacheStationsFilesByRecords(stationRecords);
 
     // All station files are here, start analysing.
-    for (StationRecord station : stationRecords) {
-      dataAnalyzer.onStationStart(station);
-      final DataFileReader reader =
-          new DataFileReader().open(cache.stationDataLocalFile(station.id));
+    final ExecutorService executor = Executors.newFixedThreadPool(numThreads);
+    try {
+      final int maxPending = numThreads * PENDING_STATIONS_PER_THREAD;
+      final Deque<Future<StationResult>> pending = new ArrayDeque<>();
+      int nextToSubmit = 0;
+      for (SelectedStation selectedStation : selectedStations) {
+        while (nextToSubmit < selectedStations.size() && pending.size() < maxPending) {
+          final SelectedStation stationToLoad = selectedStations.get(nextToSubmit++);
+          pending.add(executor.submit(() -> analyzeStation(cache, stationToLoad)));
+        }
+        onStationResult(selectedStation, pending.remove().get());
+      }
+    } finally {
+      executor.shutdownNow();
+    }
+  }
+
+  /**
+   * Passes the analysis of a station by a pool thread to the station's analyzers. Merges the
+   * partial analyzers and calls the other analyzers with the station's records. Called on
+   * the calling thread, in the stations order.
+   */
+  private void onStationResult(SelectedStation selectedStation, StationResult stationResult) {
+    final StationRecord station = selectedStation.station;
+    if (!quiet) {
+      out.printf("*** %s\n", station);
+    }
+    for (int i = 0; i < selectedStation.queries.size(); i++) {
+      final Query query = selectedStation.queries.get(i);
+      if (stationResult.partialAnalyzers[i] != null) {
+        query.dataAnalyzer.mergePartialAnalyzer(stationResult.partialAnalyzers[i]);
+        continue;
+      }
+      query.dataAnalyzer.onStationStart(station);
+      for (DataRecord data : stationResult.records) {
+        // With a single query, all the records already passed its selector.
+        if (selectedStation.queries.size() == 1 || query.dataSelector.onDataRecord(data)) {
+          query.dataAnalyzer.onDataRecord(station, data);
+        }
+      }
+      query.dataAnalyzer.onStationEnd(station);
+    }
+  }
+
+  /**
+   * Loads the data of a single station and runs it through the partial analyzers of the
+   * station's queries, for the queries whose analyzers support it. Called by the pool threads.
+   */
+  private StationResult analyzeStation(LocalFileCache cache, SelectedStation selectedStation)
+      throws Exception {
+    return analyzeRecords(selectedStation, useSeriesCache
+        ? loadStationData(cache, selectedStation)
+        : readStationData(cache, selectedStation));
+  }
+
+  /**
+   * Runs the selected data records of a single station through the partial analyzers of the
+   * station's queries. Called by the pool threads.
+   */
+  private static StationResult analyzeRecords(SelectedStation selectedStation,
+                                              List<DataRecord> records) {
+    final StationRecord station = selectedStation.station;
+    final DataAnalyzer[] partialAnalyzers = new DataAnalyzer[selectedStation.queries.size()];
+    boolean recordsNeeded = false;
+    for (int i = 0; i < partialAnalyzers.length; i++) {
+      final Query query = selectedStation.queries.get(i);
+      final DataAnalyzer partialAnalyzer = query.dataAnalyzer.newPartialAnalyzer();
+      if (partialAnalyzer == null) {
+        recordsNeeded = true;
+        continue;
+      }
+      partialAnalyzer.onStationStart(station);
+      for (DataRecord data : records) {
+        if (query.dataSelector.onDataRecord(data)) {
+          partialAnalyzer.onDataRecord(station, data);
+        }
+      }
+      partialAnalyzer.onStationEnd(station);
+      partialAnalyzers[i] = partialAnalyzer;
+    }
+    return new StationResult(recordsNeeded ? records : Collections.emptyList(), partialAnalyzers);
+  }
+
+  /**
+   * Reads and parses the data file of a single station and returns the data records that
+   * passed the data filtering of at least one of its queries. Called by the parser threads.
+   */
+  private static List<DataRecord> readStationData(LocalFileCache cache,
+                                                  SelectedStation selectedStation) throws Exception {
+    final List<DataRecord> result = new ArrayList<>();
+    final DataFileReader reader = cache.openStationData(selectedStation.station.id);
+    try {
       while (reader.readNext()) {
         final DataRecord data = reader.parseTextLine();
-        if (dataSelector.onDataRecord(data)) {
-          dataAnalyzer.onDataRecord(station, data);
+        if (selectedStation.isSelected(data)) {
+          result.add(data);
         }
       }
-      dataAnalyzer.onStationEnd(station);
+    } finally {
       reader.close();
     }
+    return result;
+  }
+
+  /**
+   * Same as readStationData() but loads the data from the station's binary series file.
+   * Called by the parser threads.
+   */
+  private static List<DataRecord> loadStationData(LocalFileCache cache,
+                                                  SelectedStation selectedStation) throws Exception {
+    final List<DataRecord> result = new ArrayList<>();
+    for (DataRecord data : cache.loadStationSeries(selectedStation.station.id).toDataRecords()) {
+      if (selectedStation.isSelected(data)) {
+        result.add(data);
+      }
+    }
+    return result;
   }
 }
@@ -0,0 +1,63 @@
+package data;
+
+import data.DataProcessor.Query;
+import data.DataProcessor.SelectedStation;
+import data.DataProcessor.StationSelector;
+import geo.GeoBox;
+import org.junit.Test;
+
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.List;
+
+import static org.junit.Assert.*;
+
+public class DataProcessorTest {
+
+  private static final StationSelector ALL_STATIONS = new StationSelector() {
+    @Override
+    public boolean onStation(StationRecord station) {
+      return true;
+    }
+  };
+
+  private static List<String> selectedIds(StationRegistry registry, StationSelector selector) {
+    final List<String> result = new ArrayList<>();
+    final List<Query> queries = Collections.singletonList(new Query("test", selector, null, null));
+    for (SelectedStation selectedStation : DataProcessor.selectStations(registry, queries)) {
+      result.add(selectedStation.station.id);
+    }
+    return result;
+  }
+
+  @Test
+  public void testSelectsStationsOfAllCountries() throws Exception {
+    final StationRegistry registry = TestData.registry(
+        "USC00000001", "31.2361", "-94.7544",
+        "RSM00025563", "64.7333", "177.5000",
+        "CA001012010", "48.4333", "-123.3333");
+    assertEquals(Arrays.asList("USC00000001", "RSM00025563", "CA001012010"),
+        selectedIds(registry, ALL_STATIONS));
+  }
+
+  @Test
+  public void testBoundingBoxOutsideOfUs() throws Exception {
+    final StationRegistry registry = TestData.registry(
+        "USC00000001", "31.2361", "-94.7544",
+        "GME00102380", "48.1000", "11.5000",
+        "FRE00104144", "48.8000", "2.3000");
+    final GeoBox europe = new GeoBox(45, 0, 55, 15);
+    assertEquals(Arrays.asList("GME00102380", "FRE00104144"), selectedIds(registry, new StationSelector() {
+      @Override
+      public boolean onStation(StationRecord station) {
+        return true;
+      }
+
+      @Override
+      public GeoBox boundingBox() {
+        return europe;
+      }
+    }));
+  }
+}
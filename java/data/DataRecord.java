@@ -7,23 +7,41 @@ import com.sun.istack.internal.Nullable;
  * includes the daily values of a single metric for a given month.
  */
 public class DataRecord {
-  private static final int MAX_DAYS_IN_MONTH = 31;
+  public static final int MAX_DAYS_IN_MONTH = 31;
   private static final int NUMBER_OF_MONTHS_PER_YEAR = 12;
 
+  // Raw value used by GHCN to indicate a missing daily value.
+  public static final int MISSING_VALUE = -9999;
+
+  // Layout of a .dly text line. Each daily value is a 5 chars right aligned int
+  // followed by 3 flag chars.
+  private static final int YEAR_OFFSET = 11;
+  private static final int MONTH_OFFSET = 15;
+  private static final int TYPE_OFFSET = 17;
+  private static final int FIRST_VALUE_OFFSET = 21;
+  private static final int VALUE_LENGTH = 5;
+  private static final int BYTES_PER_DAY = 8;
+
   public enum Type {
     PRCP("PRCP", 0.1f),
     TAVG("TAVG", 0.1f),
     TMIN("TMIN", 0.1f),
     TMAX("TMAX", 0.1f);
 
+    // Cached since values() returns a new copy on each call.
+    private static final Type[] TYPES = values();
+
     // Type code string in GHCN files.
     private final String typeCode;
+    // The four chars of typeCode packed into an int, for allocation free matching.
+    private final int packedTypeCode;
     // Scalar for converting raw int values to proper units. Multiply the int value
     // in the data files with this const.
-    private final Float valueScalar;
+    private final float valueScalar;
 
     private Type(String typeCode, float valueScaler) {
       this.typeCode = typeCode;
+      this.packedTypeCode = packTypeCode(typeCode, 0);
       this.valueScalar = valueScaler;
     }
 
@@ -33,81 +51,158 @@ public class DataRecord {
      */
     @Nullable
     public static Type parseType(String typeStr) {
-      for (Type type : values()) {
-        if (type.typeCode.equals(typeStr)) {
+      return typeStr.length() == 4 ? fromPackedTypeCode(packTypeCode(typeStr, 0)) : null;
+    }
+
+    /**
+     * Matches a type code packed with packTypeCode() and return the matching enum value
+     * or null if not found.
+     */
+    @Nullable
+    public static Type fromPackedTypeCode(int packedTypeCode) {
+      for (Type type : TYPES) {
+        if (type.packedTypeCode == packedTypeCode) {
           return type;
         }
       }
       return null;
     }
-  }
 
-  // The original textLine from the stations file.
-  public final String textLine;
+    /** Converts a raw int value from the data file to this type's units. */
+    public float scale(int rawValue) {
+      return rawValue * valueScalar;
+    }
+
+    /** Converts a sum of raw int values to this type's units. */
+    public double scaleSum(long rawSum) {
+      return rawSum * (double) valueScalar;
+    }
+  }
 
   // Parsed data
-  public final String stationCode;
-  public final String country;
+  // The station id packed with StationRegistry.packStationId(). A compact handle that is
+  // resolved to the station's metadata with StationRegistry.indexOfKey().
+  public final long stationKey;
   public final int year;
   public final int month;
   public final Type type;
 
-  // The numeric values for the month's days. Missing values are indicated with
-  // null. Would be nice to make immutable.
-  public Float[] values;
+  // The raw int values for the month's days, in the units of the data file (e.g.
+  // tenth of C). Missing values are indicated with MISSING_VALUE. Would be nice to
+  // make immutable.
+  public final int[] rawValues;
 
 
-  DataRecord(String textLine, String stationCode, String country, int year, int month, Type type, Float[] values) {
-    this.textLine = textLine;
-    this.stationCode = stationCode;
-    this.country = country;
+  DataRecord(long stationKey, int year, int month, Type type, int[] rawValues) {
+    this.stationKey = stationKey;
     this.year = year;
     this.month = month;
     this.type = type;
-    this.values = values;
+    this.rawValues = rawValues;
   }
 
-  static boolean isAcceptedTextLine(String textLine) {
+  /** The station id, e.g. "USC00045123". Allocates a new string on each call. */
+  public String stationId() {
+    return StationRegistry.unpackStationId(stationKey);
+  }
+
+  /** The two letters country code of the station, e.g. "US". */
+  public String country() {
+    return stationId().substring(0, 2);
+  }
+
+  /** Returns true if the given day (0 based) has a value. */
+  public boolean hasValue(int dayIndex) {
+    return rawValues[dayIndex] != MISSING_VALUE;
+  }
+
+  /**
+   * Returns the value of the given day (0 based) in the type's units. Call only if
+   * hasValue(dayIndex) is true.
+   */
+  public float value(int dayIndex) {
+    return type.scale(rawValues[dayIndex]);
+  }
+
+  static boolean isAcceptedTextLine(CharSequence textLine) {
     // TODO: explain rationale for rejecting station records shorter than 269 chars (copied from Heller).
     if (textLine.length() < 269) {
       return false;
     }
 
-    // For now we support only TMIN and TMAX
-    final String typeStr = textLine.substring(17, 21);
-    return Type.parseType(typeStr) != null;
+    // For now we support only the types listed in Type.
+    return Type.fromPackedTypeCode(packTypeCode(textLine, TYPE_OFFSET)) != null;
   }
 
   /**
-   * Parse a station file record.
+   * Parse a station file record. The line is accessed in place, char by char, so callers
+   * can pass a reusable view over a larger buffer.
    *
    * @param textLine a text textLine from the stations file that passed
    *                 the isAcceptedTextLine criteria.
    * @return a data.StationRecord with the station's metadata.
    */
-  static DataRecord parseFromTextLine(String textLine) {
+  static DataRecord parseFromTextLine(CharSequence textLine) {
     assert isAcceptedTextLine(textLine) : textLine;
 
-    final String stationCode = textLine.substring(0, 11);
-    final String country = textLine.substring(0, 2);
-    final int year = Integer.valueOf(textLine.substring(11, 15));
-    final int month = Integer.valueOf(textLine.substring(15, 17));
-    final String typeStr = textLine.substring(17, 21);
+    final long stationKey = StationRegistry.packStationId(textLine, 0);
+    if (stationKey < 0) {
+      throw new NumberFormatException("Invalid station id: " + textLine);
+    }
+    final int year = parseDigits(textLine, YEAR_OFFSET, 4);
+    final int month = parseDigits(textLine, MONTH_OFFSET, 2);
 
     // Parse the type. We already verified in isAcceptedTextLine that it's recognized.
-    final Type type = Type.parseType(typeStr);
+    final Type type = Type.fromPackedTypeCode(packTypeCode(textLine, TYPE_OFFSET));
 
-    int position = 21;
-    final Float[] values = new Float[MAX_DAYS_IN_MONTH];
+    final int[] rawValues = new int[MAX_DAYS_IN_MONTH];
+    int position = FIRST_VALUE_OFFSET;
     for (int i = 0; i < MAX_DAYS_IN_MONTH; i++) {
-      final String strValue = textLine.substring(position, position + 5).trim();
-      final int intValue = Integer.valueOf(strValue);
-      // -9999 is the 'no value'
-      values[i] = (intValue == -9999) ? null : intValue * type.valueScalar;
-      position += 8;
+      rawValues[i] = parseValue(textLine, position);
+      position += BYTES_PER_DAY;
     }
 
-    return new DataRecord(textLine, stationCode, country, year, month, type, values);
+    return new DataRecord(stationKey, year, month, type, rawValues);
+  }
+
+  /** Packs the four chars of a type code starting at offset into an int. */
+  static int packTypeCode(CharSequence text, int offset) {
+    return (text.charAt(offset) & 0xff) << 24
+        | (text.charAt(offset + 1) & 0xff) << 16
+        | (text.charAt(offset + 2) & 0xff) << 8
+        | (text.charAt(offset + 3) & 0xff);
+  }
+
+  /** Parses an unsigned int of exactly 'length' digits. */
+  private static int parseDigits(CharSequence text, int offset, int length) {
+    int result = 0;
+    for (int i = offset; i < offset + length; i++) {
+      final int digit = text.charAt(i) - '0';
+      if (digit < 0 || digit > 9) {
+        throw new NumberFormatException("Not a digit at " + i + ": " + text);
+      }
+      result = result * 10 + digit;
+    }
+    return result;
+  }
+
+  /** Parses a 5 chars daily value field. Leading spaces and a minus sign are allowed. */
+  private static int parseValue(CharSequence text, int offset) {
+    final int end = offset + VALUE_LENGTH;
+    int i = offset;
+    while (i < end && text.charAt(i) == ' ') {
+      i++;
+    }
+    boolean negative = false;
+    if (i < end && text.charAt(i) == '-') {
+      negative = true;
+      i++;
+    }
+    if (i == end) {
+      throw new NumberFormatException("Missing value at " + offset + ": " + text);
+    }
+    final int result = parseDigits(text, i, end - i);
+    return negative ? -result : result;
   }
 
 
@@ -115,12 +210,12 @@ public class DataRecord {
   @Override
   public String toString() {
     final StringBuilder builder = new StringBuilder();
-    for (int i = 0; i < values.length; i++) {
+    for (int i = 0; i < rawValues.length; i++) {
       if (i > 0) {
         builder.append(" ");
       }
-      builder.append(values[i] == null ? " __ " : String.format("%.1f", values[i]));
+      builder.append(hasValue(i) ? String.format("%.1f", value(i)) : " __ ");
     }
-    return String.format("[%s] [%s] [%d/%02d] [%s] [%s]", stationCode, country, year, month, type, builder);
+    return String.format("[%s] [%s] [%d/%02d] [%s] [%s]", stationId(), country(), year, month, type, builder);
   }
-}
\ No newline at end of file
+}
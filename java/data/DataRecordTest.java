@@ -0,0 +1,59 @@
+package data;
+
+import org.junit.Test;
+
+import static org.junit.Assert.*;
+
+public class DataRecordTest {
+
+  private static final float DELTA = 0.00001f;
+
+  // Constructs a .dly text line with the given daily raw values and empty flags.
+  private static String textLine(String header, int... rawValues) {
+    final StringBuilder builder = new StringBuilder(header);
+    for (int i = 0; i < 31; i++) {
+      builder.append(String.format("%5d   ", i < rawValues.length ? rawValues[i] : -9999));
+    }
+    return builder.toString();
+  }
+
+  @Test
+  public void testIsAcceptedTextLine() {
+    assertFalse(DataRecord.isAcceptedTextLine(""));
+    // good.
+    assertTrue(DataRecord.isAcceptedTextLine(textLine("USC00045123195007TMAX", 250)));
+    // Unsupported type.
+    assertFalse(DataRecord.isAcceptedTextLine(textLine("USC00045123195007SNOW", 250)));
+    // Too short.
+    assertFalse(DataRecord.isAcceptedTextLine("USC00045123195007TMAX  250"));
+  }
+
+  @Test
+  public void testParseFromTextLine() {
+    final DataRecord dr = DataRecord.parseFromTextLine(
+        textLine("USC00045123195007TMAX", 250, -123, -9999, 0, 12345));
+    assertEquals("USC00045123", dr.stationId());
+    assertEquals("US", dr.country());
+    assertEquals(1950, dr.year);
+    assertEquals(7, dr.month);
+    assertEquals(DataRecord.Type.TMAX, dr.type);
+    assertEquals(31, dr.rawValues.length);
+    assertEquals(25.0f, dr.value(0), DELTA);
+    assertEquals(-12.3f, dr.value(1), DELTA);
+    assertFalse(dr.hasValue(2));
+    assertEquals(0f, dr.value(3), DELTA);
+    assertEquals(12345, dr.rawValues[4]);
+    assertFalse(dr.hasValue(30));
+  }
+
+  @Test
+  public void testStationKey() {
+    final DataRecord first = DataRecord.parseFromTextLine(textLine("USC00045123195007TMAX", 1));
+    final DataRecord second = DataRecord.parseFromTextLine(textLine("USC00045123195007TMIN", 2));
+    assertEquals(first.stationKey, second.stationKey);
+    assertEquals(StationRegistry.packStationId("USC00045123", 0), first.stationKey);
+    final DataRecord other = DataRecord.parseFromTextLine(textLine("USC00045124195007TMIN", 2));
+    assertNotEquals(first.stationKey, other.stationKey);
+    assertEquals("USC00045124", other.stationId());
+  }
+}
@@ -0,0 +1,97 @@
+package data;
+
+/**
+ * Allocation free parsing and formatting of the fixed point decimal numbers of the GHCN files,
+ * such as "  39.6155" or "-104.7785". Faster than Double.parseDouble() on substrings and
+ * String.format().
+ */
+public class Decimals {
+  // Powers of ten that are exact as doubles.
+  private static final double[] POWERS_OF_TEN = new double[19];
+  private static final long[] LONG_POWERS_OF_TEN = new long[19];
+
+  static {
+    long power = 1;
+    for (int i = 0; i < POWERS_OF_TEN.length; i++) {
+      LONG_POWERS_OF_TEN[i] = power;
+      POWERS_OF_TEN[i] = power;
+      power *= 10;
+    }
+  }
+
+  private Decimals() {
+  }
+
+  /**
+   * Parses the decimal number in text[start, end). Leading and trailing spaces and a leading
+   * minus sign are allowed. Up to 18 digits are supported.
+   */
+  public static double parse(CharSequence text, int start, int end) {
+    while (start < end && text.charAt(start) == ' ') {
+      start++;
+    }
+    while (end > start && text.charAt(end - 1) == ' ') {
+      end--;
+    }
+    boolean negative = false;
+    if (start < end && (text.charAt(start) == '-' || text.charAt(start) == '+')) {
+      negative = text.charAt(start) == '-';
+      start++;
+    }
+    long mantissa = 0;
+    int digits = 0;
+    int fractionDigits = -1;
+    for (int i = start; i < end; i++) {
+      final char c = text.charAt(i);
+      if (c == '.' && fractionDigits < 0) {
+        fractionDigits = 0;
+        continue;
+      }
+      final int digit = c - '0';
+      if (digit < 0 || digit > 9 || ++digits >= POWERS_OF_TEN.length) {
+        throw new NumberFormatException("Invalid decimal: [" + text.subSequence(start, end) + "]");
+      }
+      mantissa = mantissa * 10 + digit;
+      if (fractionDigits >= 0) {
+        fractionDigits++;
+      }
+    }
+    if (digits == 0) {
+      throw new NumberFormatException("Invalid decimal: [" + text.subSequence(start, end) + "]");
+    }
+    // With up to 15 digits both operands are exact so the division is correctly rounded,
+    // same as parseDouble().
+    final double result = fractionDigits > 0 ? mantissa / POWERS_OF_TEN[fractionDigits] : mantissa;
+    return negative ? -result : result;
+  }
+
+  /**
+   * Appends the value with the given number of decimal places, rounded half away from zero,
+   * same as String.format("%.Nf") for the value ranges of the GHCN data, including the sign
+   * of negative values that round to zero. Values within an ulp of a rounding tie may round
+   * differently, since the scaled value is rounded rather than the exact decimal one.
+   */
+  public static StringBuilder appendFixed(StringBuilder builder, double value, int decimals) {
+    final double scaled = Math.abs(value) * POWERS_OF_TEN[decimals];
+    if (!(scaled < Long.MAX_VALUE / 10)) {
+      // NaN, infinite or too large for the fast path.
+      return builder.append(String.format("%." + decimals + "f", value));
+    }
+    final long rounded = Math.round(scaled);
+    // Like "%.Nf", negative values that round to zero, and -0.0, keep their sign.
+    if (value < 0 || (value == 0 && 1 / value < 0)) {
+      builder.append('-');
+    }
+    final long divisor = LONG_POWERS_OF_TEN[decimals];
+    builder.append(rounded / divisor);
+    if (decimals > 0) {
+      builder.append('.');
+      final long fraction = rounded % divisor;
+      for (long d = divisor / 10; d > fraction && d > 1; d /= 10) {
+        builder.append('0');
+      }
+      builder.append(fraction);
+    }
+    return builder;
+  }
+}
@@ -0,0 +1,49 @@
+package data;
+
+import org.junit.Test;
+
+import java.util.Locale;
+
+import static org.junit.Assert.*;
+
+public class DecimalsTest {
+
+  @Test
+  public void testParse() {
+    assertEquals(39.6155, Decimals.parse("  39.6155", 0, 9), 0);
+    assertEquals(-104.7785, Decimals.parse("-104.7785 ", 0, 10), 0);
+    assertEquals(1780.9, Decimals.parse("x1780.9x", 1, 7), 0);
+    assertEquals(-999.9, Decimals.parse(" -999.9", 0, 7), 0);
+    assertEquals(12, Decimals.parse("12", 0, 2), 0);
+  }
+
+  @Test(expected = NumberFormatException.class)
+  public void testParseInvalid() {
+    Decimals.parse("  12a.5", 0, 7);
+  }
+
+  @Test
+  public void testAppendFixed() {
+    assertEquals("39.6155", Decimals.appendFixed(new StringBuilder(), 39.6155, 4).toString());
+    assertEquals("-104.0500", Decimals.appendFixed(new StringBuilder(), -104.05, 4).toString());
+    assertEquals("-0.0", Decimals.appendFixed(new StringBuilder(), -0.01, 1).toString());
+    assertEquals("-0.00", Decimals.appendFixed(new StringBuilder(), -0.0, 2).toString());
+    assertEquals("0.0", Decimals.appendFixed(new StringBuilder(), 0.01, 1).toString());
+    assertEquals("-0", Decimals.appendFixed(new StringBuilder(), -0.4, 0).toString());
+    assertEquals("87.8", Decimals.appendFixed(new StringBuilder(), 87.8f, 1).toString());
+    assertEquals("3", Decimals.appendFixed(new StringBuilder(), 2.5, 0).toString());
+  }
+
+  @Test
+  public void testAppendFixedSameAsFormat() {
+    // Values away from the rounding ties that differ between the double and decimal values.
+    final double[] values = {0, -0.0, 0.04, -0.04, 1.25, -1.25, 12.5, -12.5, 3.14159, -2.71828,
+        87.8f, -0.0001, 1e6 + 0.5};
+    for (double value : values) {
+      for (int decimals = 0; decimals <= 4; decimals++) {
+        assertEquals(value + " " + decimals, String.format(Locale.ROOT, "%." + decimals + "f", value),
+            Decimals.appendFixed(new StringBuilder(), value, decimals).toString());
+      }
+    }
+  }
+}
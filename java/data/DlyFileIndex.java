@@ -0,0 +1,224 @@
+package data;
+
+import com.sun.istack.internal.Nullable;
+
+import java.io.*;
+import java.nio.ByteBuffer;
+import java.nio.channels.FileChannel;
+import java.nio.file.Files;
+import java.nio.file.StandardCopyOption;
+import java.nio.file.StandardOpenOption;
+import java.util.Arrays;
+import java.util.HashSet;
+import java.util.Set;
+
+/**
+ * An index of a file with the concatenated .dly files of many stations, such as the
+ * contents of NOAA's ghcnd_all.tar.gz. Maps each station to the byte range [begin, end) of
+ * its lines, so the data of selected stations can be read without scanning the whole file.
+ *
+ * <p>The index is built with a single scan of the data file and saved in a sidecar file
+ * named [data file].idx, which is used as long as the data file doesn't change.</p>
+ *
+ * <p>Sidecar format (big endian): magic, format version, data file size, data file
+ * modification time, number of stations, and per station, sorted by key, the packed station
+ * id (see StationRegistry.packStationId()) and the begin and end offsets.</p>
+ */
+public class DlyFileIndex {
+  private static final int MAGIC = 0x47484e49;  // "GHNI"
+  // Increment when the format of the sidecar file changes.
+  private static final int FORMAT_VERSION = 1;
+
+  private static final int STATION_ID_LENGTH = 11;
+  private static final int SCAN_BUFFER_SIZE = 1024 * 1024;
+
+  // The indexed data file.
+  public final File dataFile;
+
+  // Per station, sorted by key.
+  private final long[] keys;
+  private final long[] begins;
+  private final long[] ends;
+
+  private DlyFileIndex(File dataFile, long[] keys, long[] begins, long[] ends) {
+    this.dataFile = dataFile;
+    this.keys = keys;
+    this.begins = begins;
+    this.ends = ends;
+  }
+
+  /** The sidecar index file of the given data file. */
+  public static File indexFile(File dataFile) {
+    return new File(dataFile.getPath() + ".idx");
+  }
+
+  /**
+   * Returns the index of the given data file. Reads the sidecar index file if it's up to
+   * date, otherwise scans the data file and (re)writes the sidecar file.
+   */
+  public static DlyFileIndex load(File dataFile) throws IOException {
+    final File indexFile = indexFile(dataFile);
+    final DlyFileIndex cachedIndex = read(indexFile, dataFile);
+    if (cachedIndex != null) {
+      return cachedIndex;
+    }
+    final DlyFileIndex index = build(dataFile);
+    index.write(indexFile);
+    return index;
+  }
+
+  /**
+   * Scans the data file and returns its index. The lines of each station must be
+   * contiguous, as in the concatenation of per station .dly files.
+   */
+  public static DlyFileIndex build(File dataFile) throws IOException {
+    long[] keys = new long[1024];
+    long[] begins = new long[1024];
+    long[] ends = new long[1024];
+    int size = 0;
+    final Set<Long> seenKeys = new HashSet<>();
+
+    final StringBuilder lineId = new StringBuilder(STATION_ID_LENGTH);
+    long currentKey = -1;
+    long offset = 0;
+    long lineStart = 0;
+    try (InputStream in = new FileInputStream(dataFile)) {
+      final byte[] bytes = new byte[SCAN_BUFFER_SIZE];
+      int count;
+      while ((count = in.read(bytes)) > 0) {
+        for (int i = 0; i < count; i++, offset++) {
+          final byte b = bytes[i];
+          if (b == '\n') {
+            lineStart = offset + 1;
+            lineId.setLength(0);
+            continue;
+          }
+          if (lineId.length() >= STATION_ID_LENGTH) {
+            continue;
+          }
+          lineId.append((char) (b & 0xff));
+          if (lineId.length() < STATION_ID_LENGTH) {
+            continue;
+          }
+          // Lines with no valid station id are left in the range of the current station,
+          // and skipped by the reader.
+          final long key = StationRegistry.packStationId(lineId, 0);
+          if (key < 0 || key == currentKey) {
+            continue;
+          }
+          if (!seenKeys.add(key)) {
+            throw new IOException(String.format("%s: lines of station %s are not contiguous at offset %d",
+                dataFile, lineId, lineStart));
+          }
+          if (size > 0) {
+            ends[size - 1] = lineStart;
+          }
+          if (size == keys.length) {
+            keys = Arrays.copyOf(keys, size * 2);
+            begins = Arrays.copyOf(begins, size * 2);
+            ends = Arrays.copyOf(ends, size * 2);
+          }
+          keys[size] = key;
+          begins[size] = lineStart;
+          size++;
+          currentKey = key;
+        }
+      }
+    }
+    if (size > 0) {
+      ends[size - 1] = offset;
+    }
+    return sorted(dataFile, Arrays.copyOf(keys, size), Arrays.copyOf(begins, size),
+        Arrays.copyOf(ends, size));
+  }
+
+  // Returns an index with the entries sorted by key.
+  private static DlyFileIndex sorted(File dataFile, long[] keys, long[] begins, long[] ends) {
+    final Integer[] order = new Integer[keys.length];
+    for (int i = 0; i < order.length; i++) {
+      order[i] = i;
+    }
+    Arrays.sort(order, (a, b) -> Long.compare(keys[a], keys[b]));
+    final long[] sortedKeys = new long[keys.length];
+    final long[] sortedBegins = new long[keys.length];
+    final long[] sortedEnds = new long[keys.length];
+    for (int i = 0; i < order.length; i++) {
+      sortedKeys[i] = keys[order[i]];
+      sortedBegins[i] = begins[order[i]];
+      sortedEnds[i] = ends[order[i]];
+    }
+    return new DlyFileIndex(dataFile, sortedKeys, sortedBegins, sortedEnds);
+  }
+
+  // Writes the index under a temporary name and renames it when complete, so a partial
+  // file is never used.
+  private void write(File indexFile) throws IOException {
+    final File tmpFile = new File(indexFile.getPath() + ".tmp");
+    try (DataOutputStream out = new DataOutputStream(new BufferedOutputStream(new FileOutputStream(tmpFile)))) {
+      out.writeInt(MAGIC);
+      out.writeInt(FORMAT_VERSION);
+      out.writeLong(dataFile.length());
+      out.writeLong(dataFile.lastModified());
+      out.writeInt(keys.length);
+      for (int i = 0; i < keys.length; i++) {
+        out.writeLong(keys[i]);
+        out.writeLong(begins[i]);
+        out.writeLong(ends[i]);
+      }
+    }
+    Files.move(tmpFile.toPath(), indexFile.toPath(), StandardCopyOption.REPLACE_EXISTING);
+  }
+
+  /**
+   * Reads the index of the given data file from its sidecar file. Returns null if the
+   * sidecar file doesn't exist, has a different format version or is out of date.
+   */
+  @Nullable
+  private static DlyFileIndex read(File indexFile, File dataFile) throws IOException {
+    if (!indexFile.isFile()) {
+      return null;
+    }
+    final ByteBuffer buffer;
+    try (FileChannel channel = FileChannel.open(indexFile.toPath(), StandardOpenOption.READ)) {
+      buffer = channel.map(FileChannel.MapMode.READ_ONLY, 0, channel.size());
+    }
+    if (buffer.remaining() < 28 || buffer.getInt() != MAGIC || buffer.getInt() != FORMAT_VERSION
+        || buffer.getLong() != dataFile.length() || buffer.getLong() != dataFile.lastModified()) {
+      return null;
+    }
+    final int size = buffer.getInt();
+    final long[] keys = new long[size];
+    final long[] begins = new long[size];
+    final long[] ends = new long[size];
+    for (int i = 0; i < size; i++) {
+      keys[i] = buffer.getLong();
+      begins[i] = buffer.getLong();
+      ends[i] = buffer.getLong();
+    }
+    return new DlyFileIndex(dataFile, keys, begins, ends);
+  }
+
+  /** Number of stations in the data file. */
+  public int size() {
+    return keys.length;
+  }
+
+  /** Returns the entry of the station with the given id or -1 if it's not in the file. */
+  public int find(String stationId) {
+    final long key = StationRegistry.packStationId(stationId, 0);
+    return key < 0 ? -1 : Math.max(-1, Arrays.binarySearch(keys, key));
+  }
+
+  public long begin(int entry) {
+    return begins[entry];
+  }
+
+  public long end(int entry) {
+    return ends[entry];
+  }
+
+  /** Opens a reader on the lines of the given entry. */
+  public DataFileReader open(int entry) throws IOException {
+    return new DataFileReader().open(dataFile, begins[entry], ends[entry]);
+  }
+}
@@ -0,0 +1,43 @@
+package data;
+
+import org.junit.Test;
+
+import java.io.File;
+import java.io.PrintWriter;
+
+import static data.TestData.textLine;
+import static org.junit.Assert.*;
+
+public class DlyFileIndexTest {
+
+  @Test
+  public void testBuildAndRead() throws Exception {
+    final File dataFile = File.createTempFile("ghcnd-all", ".dly");
+    dataFile.deleteOnExit();
+    DlyFileIndex.indexFile(dataFile).deleteOnExit();
+    try (PrintWriter writer = new PrintWriter(dataFile)) {
+      writer.println(textLine("USC00000002", 1, "TMAX", 10));
+      writer.println(textLine("USC00000002", 2, "TMAX", 20));
+      writer.println(textLine("USC00000001", 1, "TMIN", 30));
+    }
+
+    final DlyFileIndex index = DlyFileIndex.load(dataFile);
+    assertEquals(2, index.size());
+    assertEquals(-1, index.find("USC00000003"));
+    final int entry = index.find("USC00000001");
+    assertTrue(entry >= 0);
+
+    final DataFileReader reader = index.open(entry);
+    assertTrue(reader.readNext());
+    final DataRecord data = reader.parseTextLine();
+    assertEquals("USC00000001", data.stationId());
+    assertEquals(30, data.rawValues[0]);
+    assertFalse(reader.readNext());
+    reader.close();
+
+    // Loaded from the sidecar file.
+    final DlyFileIndex cachedIndex = DlyFileIndex.load(dataFile);
+    assertEquals(index.begin(entry), cachedIndex.begin(cachedIndex.find("USC00000001")));
+    assertEquals(dataFile.length(), cachedIndex.end(cachedIndex.find("USC00000001")));
+  }
+}
@@ -0,0 +1,179 @@
+package data;
+
+import com.sun.istack.internal.Nullable;
+
+import java.io.ByteArrayOutputStream;
+import java.io.Closeable;
+import java.io.File;
+import java.io.FileOutputStream;
+import java.io.IOException;
+import java.io.OutputStream;
+import java.io.UncheckedIOException;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.zip.ZipEntry;
+import java.util.zip.ZipOutputStream;
+
+/**
+ * Writes a KML file of station placemarks, e.g. for Google Earth. The shared styles are
+ * written once in the document header and placemarks are written as they are added, through
+ * a BufferedTextWriter. Files named *.kmz are written as a KMZ archive (a zip with a single
+ * doc.kml entry).
+ *
+ * <p>Placemarks are grouped in layers (KML folders). Several layers can be filled in a
+ * single pass over the stations. The first layer is streamed to the file and the others
+ * are buffered in memory until close().</p>
+ */
+public class KmlWriter implements Closeable {
+
+  /** A placemark style, referenced by its id. */
+  public static class Style {
+    public final String id;
+    // Icon color in KML's aabbggrr hex format, e.g. "ff0000ff" for opaque red.
+    public final String color;
+    public final double scale;
+    public final String iconHref;
+
+    public Style(String id, String color, double scale, String iconHref) {
+      this.id = id;
+      this.color = color;
+      this.scale = scale;
+      this.iconHref = iconHref;
+    }
+
+    /** A style with the standard Google Earth circle icon. */
+    public Style(String id, String color, double scale) {
+      this(id, color, scale, "http://maps.google.com/mapfiles/kml/shapes/shaded_dot.png");
+    }
+  }
+
+  /** A folder of placemarks. */
+  public class Layer {
+    private final String name;
+    private final BufferedTextWriter writer;
+    // Non null if the layer is buffered in memory until close().
+    @Nullable
+    private final ByteArrayOutputStream bytes;
+
+    private Layer(String name, BufferedTextWriter writer, @Nullable ByteArrayOutputStream bytes) {
+      this.name = name;
+      this.writer = writer;
+      this.bytes = bytes;
+    }
+
+    /**
+     * Adds a placemark.
+     *
+     * @param styleId     id of one of the styles passed to the KmlWriter.
+     * @param description optional free text, shown when the placemark is clicked.
+     */
+    public Layer placemark(String name, String styleId, double lat, double lon,
+                           @Nullable String description) {
+      writer.append("<Placemark><name>");
+      appendEscaped(writer, name).append("</name>");
+      if (description != null) {
+        writer.append("<description>");
+        appendEscaped(writer, description).append("</description>");
+      }
+      writer.append("<styleUrl>#").append(styleId).append("</styleUrl><Point><coordinates>");
+      writer.appendFixed(lon, 4).append(',').appendFixed(lat, 4);
+      writer.append("</coordinates></Point></Placemark>").newLine();
+      return this;
+    }
+  }
+
+  private final OutputStream outputStream;
+  private final BufferedTextWriter writer;
+  private final List<Layer> layers = new ArrayList<>();
+
+  /**
+   * Creates the file and writes the document header with the given styles.
+   *
+   * @param file a .kml file, or a .kmz file for a compressed archive.
+   */
+  public KmlWriter(File file, String documentName, List<Style> styles) throws IOException {
+    if (file.getName().endsWith(".kmz")) {
+      final ZipOutputStream zip = new ZipOutputStream(new FileOutputStream(file));
+      zip.putNextEntry(new ZipEntry("doc.kml"));
+      outputStream = zip;
+    } else {
+      outputStream = new FileOutputStream(file);
+    }
+    writer = new BufferedTextWriter(outputStream);
+    writer.append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>").newLine();
+    writer.append("<kml xmlns=\"http://www.opengis.net/kml/2.2\">").newLine();
+    writer.append("<Document><name>");
+    appendEscaped(writer, documentName).append("</name>").newLine();
+    for (Style style : styles) {
+      writer.append("<Style id=\"").append(style.id).append("\"><IconStyle><color>")
+          .append(style.color).append("</color><scale>").appendFixed(style.scale, 2)
+          .append("</scale><Icon><href>").append(style.iconHref)
+          .append("</href></Icon></IconStyle></Style>").newLine();
+    }
+  }
+
+  /** Adds a layer. Layers are written in the order they are added. */
+  public Layer layer(String name) {
+    final Layer layer;
+    if (layers.isEmpty()) {
+      layer = new Layer(name, writer, null);
+      writeFolderStart(name);
+    } else {
+      final ByteArrayOutputStream bytes = new ByteArrayOutputStream();
+      layer = new Layer(name, new BufferedTextWriter(bytes), bytes);
+    }
+    layers.add(layer);
+    return layer;
+  }
+
+  private void writeFolderStart(String name) {
+    writer.append("<Folder><name>");
+    appendEscaped(writer, name).append("</name>").newLine();
+  }
+
+  /** Writes the buffered layers and the document footer and closes the file. */
+  @Override
+  public void close() throws IOException {
+    for (int i = 0; i < layers.size(); i++) {
+      final Layer layer = layers.get(i);
+      if (layer.bytes != null) {
+        writeFolderStart(layer.name);
+        layer.writer.flush();
+        writer.flush();
+        layer.bytes.writeTo(outputStream);
+      }
+      writer.append("</Folder>").newLine();
+    }
+    writer.append("</Document>").newLine();
+    writer.append("</kml>").newLine();
+    try {
+      writer.close();
+    } catch (UncheckedIOException e) {
+      throw e.getCause();
+    }
+  }
+
+  // Appends the text with the XML special chars escaped.
+  private static BufferedTextWriter appendEscaped(BufferedTextWriter writer, String text) {
+    for (int i = 0; i < text.length(); i++) {
+      final char c = text.charAt(i);
+      switch (c) {
+        case '<':
+          writer.append("&lt;");
+          break;
+        case '>':
+          writer.append("&gt;");
+          break;
+        case '&':
+          writer.append("&amp;");
+          break;
+        case '"':
+          writer.append("&quot;");
+          break;
+        default:
+          writer.append(c);
+      }
+    }
+    return writer;
+  }
+}
@@ -0,0 +1,54 @@
+package data;
+
+import org.junit.Test;
+
+import java.io.File;
+import java.io.FileInputStream;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.util.Arrays;
+import java.util.Scanner;
+import java.util.zip.ZipInputStream;
+
+import static org.junit.Assert.*;
+
+public class KmlWriterTest {
+
+  private static void writeLayers(File file) throws Exception {
+    try (KmlWriter kml = new KmlWriter(file, "Test", Arrays.asList(
+        new KmlWriter.Style("hot", "ff0000ff", 1.0), new KmlWriter.Style("cold", "ffff0000", 1.0)))) {
+      final KmlWriter.Layer hot = kml.layer("Hot");
+      final KmlWriter.Layer cold = kml.layer("Cold");
+      cold.placemark("A & B", "cold", 35.5, -97.25, null);
+      hot.placemark("C", "hot", 31.2361, -94.7544, "<1>");
+    }
+  }
+
+  @Test
+  public void testKml() throws Exception {
+    final File file = File.createTempFile("test", ".kml");
+    file.deleteOnExit();
+    writeLayers(file);
+    final String kml = new String(Files.readAllBytes(file.toPath()), StandardCharsets.UTF_8);
+    assertEquals(1, kml.split("<Style id=\"hot\">", -1).length - 1);
+    assertTrue(kml.indexOf("<name>Hot</name>") < kml.indexOf("<name>C</name>"));
+    assertTrue(kml.indexOf("<name>C</name>") < kml.indexOf("<name>Cold</name>"));
+    assertTrue(kml.contains("<name>A &amp; B</name>"));
+    assertTrue(kml.contains("<description>&lt;1&gt;</description>"));
+    assertTrue(kml.contains("<coordinates>-94.7544,31.2361</coordinates>"));
+    assertTrue(kml.trim().endsWith("</kml>"));
+  }
+
+  @Test
+  public void testKmz() throws Exception {
+    final File file = File.createTempFile("test", ".kmz");
+    file.deleteOnExit();
+    writeLayers(file);
+    try (ZipInputStream zip = new ZipInputStream(new FileInputStream(file))) {
+      assertEquals("doc.kml", zip.getNextEntry().getName());
+      final String kml = new Scanner(zip, "UTF-8").useDelimiter("\\A").next();
+      assertTrue(kml.contains("<name>A &amp; B</name>"));
+      assertTrue(kml.trim().endsWith("</kml>"));
+    }
+  }
+}
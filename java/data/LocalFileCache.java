@@ -1,11 +1,13 @@
 package data;
 
+import com.sun.istack.internal.Nullable;
 import it.sauronsoftware.ftp4j.FTPClient;
 
 import java.io.File;
 import java.io.PrintStream;
 import java.util.ArrayList;
 import java.util.List;
+import java.util.Map;
 import java.util.concurrent.*;
 import java.util.stream.Collectors;
 
@@ -24,8 +26,19 @@ public class LocalFileCache {
   // NOAA limits number of parallel connections to 2.
   private static final int MAX_FTP_CONNECTIONS = 2;
 
+  // Optional file in the cache directory with the concatenated .dly files of many stations,
+  // e.g. the extracted ghcnd_all.tar.gz. The stations it contains are read from their byte
+  // ranges in it and are not fetched. See DlyFileIndex.
+  private static final String COMBINED_DATA_FILE_NAME = "ghcnd-all.dly";
+
   private final File cacheDir;
 
+  // The index of the combined data file, or null if there is no such file. Loaded on
+  // first use.
+  @Nullable
+  private DlyFileIndex combinedDataIndex;
+  private boolean combinedDataIndexLoaded;
+
   /**
    * Create a cache instance on an existing and writeable local disk directory.
    */
@@ -45,6 +58,98 @@ public class LocalFileCache {
     return new File(cacheDir, stationId + ".dly");
   }
 
+  /**
+   * Returns the index of the combined data file in the cache, or null if there is no such
+   * file. The index is built on first use if needed.
+   */
+  @Nullable
+  public synchronized DlyFileIndex combinedDataIndex() throws Exception {
+    if (!combinedDataIndexLoaded) {
+      final File dataFile = new File(cacheDir, COMBINED_DATA_FILE_NAME);
+      if (dataFile.isFile()) {
+        out.printf("Indexing %s\n", dataFile);
+        combinedDataIndex = DlyFileIndex.load(dataFile);
+      }
+      combinedDataIndexLoaded = true;
+    }
+    return combinedDataIndex;
+  }
+
+  /**
+   * Opens a reader on the data of the given station. The data is read from the station's
+   * byte range in the combined data file if it's there, or else from the station's .dly
+   * file, which must already be in the cache.
+   *
+   * <p>Can be called in parallel for different stations.</p>
+   */
+  public DataFileReader openStationData(String stationId) throws Exception {
+    final DlyFileIndex index = combinedDataIndex();
+    final int entry = index == null ? -1 : index.find(stationId);
+    return entry >= 0 ? index.open(entry) : new DataFileReader().open(stationDataLocalFile(stationId));
+  }
+
+  // The file the data of the given station is read from.
+  private File stationDataSourceFile(String stationId) throws Exception {
+    final DlyFileIndex index = combinedDataIndex();
+    return index != null && index.find(stationId) >= 0 ? index.dataFile : stationDataLocalFile(stationId);
+  }
+
+  /**
+   * Given a station id, return a File for its parsed binary series in the cache. The file
+   * itself may or may not exist.
+   */
+  public File stationSeriesLocalFile(String stationId) throws Exception {
+    return new File(cacheDir, stationId + ".series");
+  }
+
+  /**
+   * Loads the data of a station from its binary series file. If the series file doesn't exist
+   * or is older than the station's .dly file (or the combined data file, if the station is
+   * there), the data is parsed and the series file is (re)created. The station data must
+   * already be in the cache.
+   *
+   * <p>Can be called in parallel for different stations.</p>
+   */
+  public StationSeries loadStationSeries(String stationId) throws Exception {
+    final File dataFile = stationDataSourceFile(stationId);
+    final File seriesFile = stationSeriesLocalFile(stationId);
+    final StationSeries cachedSeries = StationSeriesFile.read(seriesFile, dataFile);
+    if (cachedSeries != null) {
+      return cachedSeries;
+    }
+    final StationSeries series = new StationSeries(stationId);
+    final DataFileReader reader = openStationData(stationId);
+    try {
+      while (reader.readNext()) {
+        series.add(reader.parseTextLine());
+      }
+    } finally {
+      reader.close();
+    }
+    series.trimToSize();
+    StationSeriesFile.write(seriesFile, series, dataFile);
+    return series;
+  }
+
+  /**
+   * Loads the climatology of a station, from its binary series file when up to date (see
+   * loadStationSeries()). Any baseline window can then be queried without the raw data.
+   */
+  public StationClimatology loadStationClimatology(String stationId) throws Exception {
+    return StationClimatology.compute(loadStationSeries(stationId));
+  }
+
+  /**
+   * Loads the (year, month) cube of a station, with the given raw thresholds per type (see
+   * StationCube.compute()), from its binary series file when up to date (see
+   * loadStationSeries()). Any window of years and set of months can then be queried without
+   * the raw data.
+   */
+  public StationCube loadStationCube(String stationId, Map<DataRecord.Type, int[]> rawThresholds)
+      throws Exception {
+    return StationCube.compute(loadStationSeries(stationId), rawThresholds);
+  }
+
   /**
    * Given a list of station ids, check which ones already have thier data files in the local cache.
    *
@@ -52,8 +157,12 @@ public class LocalFileCache {
    */
   private List<String> findMissingLocalStationFiles(List<String> stationIds) throws Exception {
     List<String> result = new ArrayList();
+    final DlyFileIndex index = combinedDataIndex();
     // TODO: reading the cache directory list may be faster than checking each file.
     for (String stationId : stationIds) {
+      if (index != null && index.find(stationId) >= 0) {
+        continue;
+      }
       if (!stationDataLocalFile(stationId).exists()) {
         result.add(stationId);
       }
@@ -165,6 +274,15 @@ public class LocalFileCache {
     return new File(cacheDir, "ghcnd-stations.txt");
   }
 
+  /**
+   * Loads the registry of the stations in the stations file. If the stations file is not in
+   * the local cache, it is fetched.
+   */
+  public StationRegistry loadStationRegistry() throws Exception {
+    cacheStationsListFile();
+    return StationRegistry.load(stationsListLocalFile());
+  }
+
   /**
    * Makes sure that the stations file is in the local cache. If not, it fetches it.
    *
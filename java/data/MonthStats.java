@@ -0,0 +1,67 @@
+package data;
+
+/**
+ * Summary statistics of the raw daily values of a month, computed in a single pass. The
+ * loop has no data dependent branches, which lets the JIT compile it to conditional
+ * moves and vector instructions of the CPU it runs on.
+ *
+ * <p>Instances are mutable and meant to be reused, one per thread.</p>
+ */
+public class MonthStats {
+  // Number of days with a value.
+  public int count;
+  // Sum of the values.
+  public long sum;
+  // Number of values above the high threshold passed to compute().
+  public int aboveCount;
+  // Number of values below the low threshold passed to compute().
+  public int belowCount;
+  // Min and max values. Valid only if count > 0.
+  public int min;
+  public int max;
+
+  /** Same as compute(rawValues, Integer.MAX_VALUE, Integer.MIN_VALUE), with no thresholds. */
+  public MonthStats compute(int[] rawValues) {
+    return compute(rawValues, Integer.MAX_VALUE, Integer.MIN_VALUE);
+  }
+
+  /**
+   * Computes the stats of the given raw values, skipping DataRecord.MISSING_VALUE.
+   *
+   * @param rawValues      daily raw values, such as DataRecord.rawValues.
+   * @param highThreshold  values greater than this are counted in aboveCount.
+   * @param lowThreshold   values less than this are counted in belowCount.
+   * @return this instance.
+   */
+  public MonthStats compute(int[] rawValues, int highThreshold, int lowThreshold) {
+    int count = 0;
+    long sum = 0;
+    int aboveCount = 0;
+    int belowCount = 0;
+    int min = Integer.MAX_VALUE;
+    int max = Integer.MIN_VALUE;
+    for (int i = 0; i < rawValues.length; i++) {
+      final int value = rawValues[i];
+      final int valid = (value != DataRecord.MISSING_VALUE) ? 1 : 0;
+      count += valid;
+      // -valid is an all ones mask for valid values and zero otherwise.
+      sum += value & -valid;
+      aboveCount += (value > highThreshold) ? valid : 0;
+      belowCount += (value < lowThreshold) ? valid : 0;
+      min = Math.min(min, valid != 0 ? value : Integer.MAX_VALUE);
+      max = Math.max(max, valid != 0 ? value : Integer.MIN_VALUE);
+    }
+    this.count = count;
+    this.sum = sum;
+    this.aboveCount = aboveCount;
+    this.belowCount = belowCount;
+    this.min = min;
+    this.max = max;
+    return this;
+  }
+
+  /** Sum of the deviations of the values from the given baseline raw value. */
+  public long deviationSum(int baseline) {
+    return sum - (long) count * baseline;
+  }
+}
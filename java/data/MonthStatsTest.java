@@ -0,0 +1,31 @@
+package data;
+
+import org.junit.Test;
+
+import static org.junit.Assert.*;
+
+public class MonthStatsTest {
+
+  private static final int M = DataRecord.MISSING_VALUE;
+
+  @Test
+  public void testCompute() {
+    final MonthStats stats = new MonthStats().compute(new int[]{250, M, -30, 0, M, 400}, 250, 0);
+    assertEquals(4, stats.count);
+    assertEquals(620, stats.sum);
+    assertEquals(1, stats.aboveCount);
+    assertEquals(1, stats.belowCount);
+    assertEquals(-30, stats.min);
+    assertEquals(400, stats.max);
+    assertEquals(620 - 4 * 100, stats.deviationSum(100));
+  }
+
+  @Test
+  public void testComputeAllMissing() {
+    final MonthStats stats = new MonthStats().compute(new int[]{M, M, M});
+    assertEquals(0, stats.count);
+    assertEquals(0, stats.sum);
+    assertEquals(0, stats.aboveCount);
+    assertEquals(0, stats.belowCount);
+  }
+}
@@ -0,0 +1,140 @@
+package data;
+
+/**
+ * Single pass least squares regression of y on x. Points are added one at a time, with
+ * Welford's updates of the means and of the centered sums of squares and products, which
+ * avoids the cancellation of the naive sums of x^2 and xy on long series of years. Partial
+ * accumulators, e.g. of different threads, can be merged.
+ *
+ * <p>Results are NaN when undefined, e.g. the slope with less than two distinct x values.</p>
+ */
+public class RegressionAccumulator {
+  private long count;
+  private double meanX;
+  private double meanY;
+  // Sums of (x - meanX)^2, (y - meanY)^2 and (x - meanX)(y - meanY).
+  private double sumXX;
+  private double sumYY;
+  private double sumXY;
+
+  /** Adds a point. */
+  public void add(double x, double y) {
+    count++;
+    final double dx = x - meanX;
+    final double dy = y - meanY;
+    meanX += dx / count;
+    meanY += dy / count;
+    sumXX += dx * (x - meanX);
+    sumYY += dy * (y - meanY);
+    sumXY += dx * (y - meanY);
+  }
+
+  /** Adds the points of another accumulator. */
+  public void merge(RegressionAccumulator other) {
+    if (other.count == 0) {
+      return;
+    }
+    if (count == 0) {
+      set(other);
+      return;
+    }
+    final long total = count + other.count;
+    final double dx = other.meanX - meanX;
+    final double dy = other.meanY - meanY;
+    final double weight = (double) count * other.count / total;
+    meanX += dx * other.count / total;
+    meanY += dy * other.count / total;
+    sumXX += other.sumXX + dx * dx * weight;
+    sumYY += other.sumYY + dy * dy * weight;
+    sumXY += other.sumXY + dx * dy * weight;
+    count = total;
+  }
+
+  /**
+   * Adds the points of another accumulator as separate groups, e.g. of another station, each
+   * with its own means. Only the sums centered on the group means are added, as in a fixed
+   * effects regression, so the slope is the within group slope and the differences of levels
+   * between groups don't affect it. Use slopeStandardError(groups) for the standard error.
+   * The means are those of all the points, so intercept() isn't meaningful.
+   */
+  public void mergeWithinGroups(RegressionAccumulator other) {
+    if (other.count == 0) {
+      return;
+    }
+    final long total = count + other.count;
+    meanX += (other.meanX - meanX) * other.count / total;
+    meanY += (other.meanY - meanY) * other.count / total;
+    sumXX += other.sumXX;
+    sumYY += other.sumYY;
+    sumXY += other.sumXY;
+    count = total;
+  }
+
+  /** Sets this accumulator to a copy of the other one. */
+  public void set(RegressionAccumulator other) {
+    count = other.count;
+    meanX = other.meanX;
+    meanY = other.meanY;
+    sumXX = other.sumXX;
+    sumYY = other.sumYY;
+    sumXY = other.sumXY;
+  }
+
+  /** Removes all the points. */
+  public void reset() {
+    count = 0;
+    meanX = 0;
+    meanY = 0;
+    sumXX = 0;
+    sumYY = 0;
+    sumXY = 0;
+  }
+
+  public long count() {
+    return count;
+  }
+
+  public double meanX() {
+    return count == 0 ? Double.NaN : meanX;
+  }
+
+  public double meanY() {
+    return count == 0 ? Double.NaN : meanY;
+  }
+
+  /** Slope of the least squares line, in y units per x unit. */
+  public double slope() {
+    return sumXX > 0 ? sumXY / sumXX : Double.NaN;
+  }
+
+  /** Intercept of the least squares line, at x = 0. */
+  public double intercept() {
+    return meanY - slope() * meanX;
+  }
+
+  /** Coefficient of determination. 1 if all the y values are equal. */
+  public double rSquared() {
+    if (!(sumXX > 0)) {
+      return Double.NaN;
+    }
+    return sumYY > 0 ? Math.min(1, sumXY * sumXY / (sumXX * sumYY)) : 1;
+  }
+
+  /** Standard error of the slope. Requires at least three points. */
+  public double slopeStandardError() {
+    return slopeStandardError(1);
+  }
+
+  /**
+   * Standard error of the slope of points merged from the given number of groups with
+   * mergeWithinGroups(), each group having its own intercept. Requires at least groups + 2
+   * points.
+   */
+  public double slopeStandardError(long groups) {
+    if (count < groups + 2 || !(sumXX > 0)) {
+      return Double.NaN;
+    }
+    final double residualSumOfSquares = Math.max(0, sumYY - sumXY * sumXY / sumXX);
+    return Math.sqrt(residualSumOfSquares / (count - groups - 1) / sumXX);
+  }
+}
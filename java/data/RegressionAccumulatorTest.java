@@ -0,0 +1,94 @@
+package data;
+
+import org.junit.Test;
+
+import static org.junit.Assert.*;
+
+public class RegressionAccumulatorTest {
+
+  private static final double DELTA = 1e-9;
+
+  @Test
+  public void testExactLine() {
+    final RegressionAccumulator regression = new RegressionAccumulator();
+    for (int year = 1850; year <= 2017; year++) {
+      regression.add(year, 0.01 * year - 5);
+    }
+    assertEquals(168, regression.count());
+    assertEquals(0.01, regression.slope(), DELTA);
+    assertEquals(-5, regression.intercept(), 1e-6);
+    assertEquals(1, regression.rSquared(), DELTA);
+    assertEquals(0, regression.slopeStandardError(), DELTA);
+  }
+
+  @Test
+  public void testNoisyLine() {
+    // y = 1 + 2x with residuals +1, -1, -1, +1.
+    final RegressionAccumulator regression = new RegressionAccumulator();
+    regression.add(0, 2);
+    regression.add(1, 2);
+    regression.add(2, 4);
+    regression.add(3, 8);
+    assertEquals(2, regression.slope(), DELTA);
+    assertEquals(1, regression.intercept(), DELTA);
+    // sumXX = 5, sumYY = 24, sumXY = 10, residuals = 4.
+    assertEquals(100.0 / (5 * 24), regression.rSquared(), DELTA);
+    assertEquals(Math.sqrt(4.0 / 2 / 5), regression.slopeStandardError(), DELTA);
+  }
+
+  @Test
+  public void testMerge() {
+    final RegressionAccumulator all = new RegressionAccumulator();
+    final RegressionAccumulator first = new RegressionAccumulator();
+    final RegressionAccumulator second = new RegressionAccumulator();
+    for (int i = 0; i < 100; i++) {
+      final double y = Math.sin(i) * 3 + i * 0.2;
+      all.add(i, y);
+      (i < 30 ? first : second).add(i, y);
+    }
+    first.merge(second);
+    assertEquals(all.count(), first.count());
+    assertEquals(all.slope(), first.slope(), DELTA);
+    assertEquals(all.intercept(), first.intercept(), DELTA);
+    assertEquals(all.rSquared(), first.rSquared(), DELTA);
+    assertEquals(all.slopeStandardError(), first.slopeStandardError(), DELTA);
+  }
+
+  @Test
+  public void testMergeWithinGroups() {
+    // Two groups with the same slope, different levels and overlapping x ranges.
+    final RegressionAccumulator pooled = new RegressionAccumulator();
+    for (int group = 0; group < 2; group++) {
+      final RegressionAccumulator regression = new RegressionAccumulator();
+      for (int i = 0; i < 50; i++) {
+        final double x = group * 30 + i;
+        final double noise = Math.sin(x * 7 + group);
+        regression.add(x, 100 * group + 0.5 * x + noise);
+      }
+      pooled.mergeWithinGroups(regression);
+    }
+    assertEquals(100, pooled.count());
+    assertEquals(0.5, pooled.slope(), 0.05);
+    assertTrue(Double.isNaN(new RegressionAccumulator().slopeStandardError(2)));
+
+    // A single group is the same as the plain regression.
+    final RegressionAccumulator single = new RegressionAccumulator();
+    final RegressionAccumulator all = new RegressionAccumulator();
+    for (int i = 0; i < 10; i++) {
+      all.add(i, i * i);
+    }
+    single.mergeWithinGroups(all);
+    assertEquals(all.slope(), single.slope(), DELTA);
+    assertEquals(all.slopeStandardError(), single.slopeStandardError(1), DELTA);
+  }
+
+  @Test
+  public void testUndefined() {
+    final RegressionAccumulator regression = new RegressionAccumulator();
+    assertTrue(Double.isNaN(regression.slope()));
+    regression.add(1, 1);
+    regression.add(1, 2);
+    assertTrue(Double.isNaN(regression.slope()));
+    assertTrue(Double.isNaN(regression.slopeStandardError()));
+  }
+}
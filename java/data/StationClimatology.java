@@ -0,0 +1,108 @@
+package data;
+
+import data.DataRecord.Type;
+
+/**
+ * The climatology of a single station: per type, the mean and number of values of each
+ * month and each day of the year, over any window of baseline years.
+ *
+ * <p>The values are summed into per year buckets (the 366 days of the year, in the layout of
+ * DailyRecordTracker.dayOfYear(), then the 12 months) which are accumulated over the years.
+ * The totals of a window of years are the difference of two rows, so changing the baseline
+ * costs O(1) per station and month or day, with no pass over the data.</p>
+ */
+public class StationClimatology {
+  private static final int MONTHS = 12;
+  private static final int DAYS_OF_YEAR = DailyRecordTracker.DAYS_OF_YEAR;
+  // Buckets per year: the days of the year, then the months.
+  private static final int BUCKETS = DAYS_OF_YEAR + MONTHS;
+
+  // Station ID id. E.g. "USW00093901"
+  public final String stationId;
+
+  // The rows of the totals, with an entry per bucket.
+  private final YearPrefix years;
+
+  // Per type, indexed by Type.ordinal(), the cumulative raw sums and counts, indexed by
+  // YearPrefix row * BUCKETS + bucket. Null for types with no values.
+  private final long[][] sums = new long[Type.values().length][];
+  private final int[][] counts = new int[Type.values().length][];
+
+  private StationClimatology(String stationId, YearPrefix years) {
+    this.stationId = stationId;
+    this.years = years;
+  }
+
+  /** Computes the climatology of the given station data, in a single pass over the values. */
+  public static StationClimatology compute(StationSeries series) {
+    final YearPrefix years = new YearPrefix(series, BUCKETS);
+    final StationClimatology result = new StationClimatology(series.stationId, years);
+    for (Type type : Type.values()) {
+      if (!series.hasType(type)) {
+        continue;
+      }
+      final long[] sums = new long[years.size()];
+      final int[] counts = new int[years.size()];
+      series.forEachValue(type, (year, month, day, rawValue) -> {
+        final int dayBucket = years.index(year, DailyRecordTracker.dayOfYear(month, day));
+        final int monthBucket = years.index(year, DAYS_OF_YEAR + month - 1);
+        sums[dayBucket] += rawValue;
+        counts[dayBucket]++;
+        sums[monthBucket] += rawValue;
+        counts[monthBucket]++;
+      });
+      years.accumulate(sums);
+      years.accumulate(counts, 1);
+      result.sums[type.ordinal()] = sums;
+      result.counts[type.ordinal()] = counts;
+    }
+    return result;
+  }
+
+  /** Number of values of the given type and month (1 based) in the years [firstYear, lastYear]. */
+  public int monthCount(Type type, int month, int firstYear, int lastYear) {
+    return count(type, DAYS_OF_YEAR + month - 1, firstYear, lastYear);
+  }
+
+  /**
+   * Mean value, in the type's units, of the given type and month (1 based) in the years
+   * [firstYear, lastYear]. NaN if there are no values.
+   */
+  public double monthMean(Type type, int month, int firstYear, int lastYear) {
+    return mean(type, DAYS_OF_YEAR + month - 1, firstYear, lastYear);
+  }
+
+  /** Number of values of the given type and day of the year in the years [firstYear, lastYear]. */
+  public int dayCount(Type type, int month, int day, int firstYear, int lastYear) {
+    return count(type, DailyRecordTracker.dayOfYear(month, day), firstYear, lastYear);
+  }
+
+  /**
+   * Mean value, in the type's units, of the given type and day of the year in the years
+   * [firstYear, lastYear]. NaN if there are no values.
+   */
+  public double dayMean(Type type, int month, int day, int firstYear, int lastYear) {
+    return mean(type, DailyRecordTracker.dayOfYear(month, day), firstYear, lastYear);
+  }
+
+  private int count(Type type, int bucket, int firstYear, int lastYear) {
+    final int[] counts = this.counts[type.ordinal()];
+    final int beginRow = years.beginRow(firstYear);
+    final int endRow = years.endRow(lastYear);
+    if (counts == null || beginRow >= endRow) {
+      return 0;
+    }
+    return counts[endRow * BUCKETS + bucket] - counts[beginRow * BUCKETS + bucket];
+  }
+
+  private double mean(Type type, int bucket, int firstYear, int lastYear) {
+    final int count = count(type, bucket, firstYear, lastYear);
+    if (count == 0) {
+      return Double.NaN;
+    }
+    final long[] sums = this.sums[type.ordinal()];
+    final long sum = sums[years.endRow(lastYear) * BUCKETS + bucket]
+        - sums[years.beginRow(firstYear) * BUCKETS + bucket];
+    return type.scaleSum(sum) / count;
+  }
+}
@@ -0,0 +1,70 @@
+package data;
+
+import data.DataRecord.Type;
+import org.junit.Test;
+
+import java.util.Arrays;
+
+import static data.TestData.record;
+import static org.junit.Assert.*;
+
+public class StationClimatologyTest {
+
+  private static final double DELTA = 1e-6;
+
+  private static StationClimatology climatology() {
+    final StationSeries series = new StationSeries("USC00000001");
+    for (int year = 1950; year <= 2000; year++) {
+      // January TMAX is year - 1950 tenth of C, e.g. 1 C in 1960.
+      series.add(record(year, 1, Type.TMAX, year - 1950));
+      series.add(record(year, 2, Type.TMAX, 100));
+    }
+    // A single TMIN value on Feb 29th.
+    final int[] rawValues = new int[DataRecord.MAX_DAYS_IN_MONTH];
+    Arrays.fill(rawValues, DataRecord.MISSING_VALUE);
+    rawValues[28] = -50;
+    series.add(new DataRecord(series.stationKey, 1960, 2, Type.TMIN, rawValues));
+    return StationClimatology.compute(series);
+  }
+
+  @Test
+  public void testMonthMeans() {
+    final StationClimatology climatology = climatology();
+    assertEquals(31 * 11, climatology.monthCount(Type.TMAX, 1, 1960, 1970));
+    assertEquals(1.5, climatology.monthMean(Type.TMAX, 1, 1960, 1970), DELTA);
+    assertEquals(0, climatology.monthMean(Type.TMAX, 1, 1950, 1950), DELTA);
+    assertEquals(10, climatology.monthMean(Type.TMAX, 2, 1951, 1990), DELTA);
+    assertEquals(0, climatology.monthCount(Type.TMAX, 3, 1951, 1990));
+    assertTrue(Double.isNaN(climatology.monthMean(Type.TMAX, 3, 1951, 1990)));
+    assertTrue(Double.isNaN(climatology.monthMean(Type.PRCP, 1, 1951, 1990)));
+  }
+
+  @Test
+  public void testWindowOutsideOfData() {
+    final StationClimatology climatology = climatology();
+    // Clamped to 1950-2000.
+    assertEquals(31 * 51, climatology.monthCount(Type.TMAX, 1, 1900, 2100));
+    assertEquals(2.5, climatology.monthMean(Type.TMAX, 1, 1900, 2100), DELTA);
+    assertEquals(0, climatology.monthCount(Type.TMAX, 1, 2001, 2010));
+    assertEquals(0, climatology.monthCount(Type.TMAX, 1, 1970, 1960));
+  }
+
+  @Test
+  public void testDayMeans() {
+    final StationClimatology climatology = climatology();
+    assertEquals(11, climatology.dayCount(Type.TMAX, 1, 15, 1960, 1970));
+    assertEquals(1.5, climatology.dayMean(Type.TMAX, 1, 15, 1960, 1970), DELTA);
+    // Feb 29th only in leap years.
+    assertEquals(13, climatology.dayCount(Type.TMAX, 2, 29, 1950, 2000));
+    assertEquals(1, climatology.dayCount(Type.TMIN, 2, 29, 1950, 2000));
+    assertEquals(-5, climatology.dayMean(Type.TMIN, 2, 29, 1950, 2000), DELTA);
+    assertEquals(0, climatology.dayCount(Type.TMIN, 3, 1, 1950, 2000));
+  }
+
+  @Test
+  public void testEmpty() {
+    final StationClimatology climatology = StationClimatology.compute(new StationSeries("USC00000001"));
+    assertEquals(0, climatology.monthCount(Type.TMAX, 1, 1900, 2000));
+    assertTrue(Double.isNaN(climatology.dayMean(Type.TMAX, 1, 1, 1900, 2000)));
+  }
+}
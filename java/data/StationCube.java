@@ -0,0 +1,157 @@
+package data;
+
+import data.DataRecord.Type;
+
+import java.util.Map;
+
+/**
+ * Aggregates of the daily values of a single station over any window of years and any set
+ * of months: per type, the number of values, their sum and the number of values above each
+ * of a few thresholds.
+ *
+ * <p>The values are summed into (year, month) cells which are accumulated over the years,
+ * so the totals of a month over a window of years are the difference of two rows. A query
+ * costs O(1) per month of its set, with no pass over the data.</p>
+ */
+public class StationCube {
+  private static final int MONTHS = 12;
+  // Month set of all the months. Bit (month - 1) is set for each month of a set.
+  public static final int ALL_MONTHS = (1 << MONTHS) - 1;
+
+  // Station ID id. E.g. "USW00093901"
+  public final String stationId;
+
+  // The rows of the totals, with an entry per month.
+  private final YearPrefix years;
+
+  // Per type, indexed by Type.ordinal(), the cumulative raw sums and counts, indexed by
+  // YearPrefix row * MONTHS + month - 1. Null for types with no values.
+  private final long[][] sums = new long[Type.values().length][];
+  private final int[][] counts = new int[Type.values().length][];
+  // Per type, the raw thresholds and the cumulative counts of values above each of them,
+  // at index (row * MONTHS + month - 1) * number of thresholds + threshold index.
+  private final int[][] thresholds = new int[Type.values().length][];
+  private final int[][] aboveCounts = new int[Type.values().length][];
+
+  private StationCube(String stationId, YearPrefix years) {
+    this.stationId = stationId;
+    this.years = years;
+  }
+
+  /** Returns the month set of the given months (1 based). */
+  public static int monthSet(int... months) {
+    int result = 0;
+    for (int month : months) {
+      if (month < 1 || month > MONTHS) {
+        throw new IllegalArgumentException("Invalid month: " + month);
+      }
+      result |= 1 << (month - 1);
+    }
+    return result;
+  }
+
+  /**
+   * Computes the cube of the given station data, in a single pass over the values.
+   *
+   * @param rawThresholds per type, the raw thresholds of countAbove(). Types with no entry
+   *     have no thresholds.
+   */
+  public static StationCube compute(StationSeries series, Map<Type, int[]> rawThresholds) {
+    final YearPrefix years = new YearPrefix(series, MONTHS);
+    final StationCube result = new StationCube(series.stationId, years);
+    for (Type type : Type.values()) {
+      final int[] thresholds = rawThresholds.containsKey(type) ? rawThresholds.get(type).clone() : new int[0];
+      result.thresholds[type.ordinal()] = thresholds;
+      if (!series.hasType(type)) {
+        continue;
+      }
+      final long[] sums = new long[years.size()];
+      final int[] counts = new int[years.size()];
+      final int[] aboveCounts = new int[years.size() * thresholds.length];
+      series.forEachValue(type, (year, month, day, rawValue) -> {
+        final int cell = years.index(year, month - 1);
+        sums[cell] += rawValue;
+        counts[cell]++;
+        for (int i = 0; i < thresholds.length; i++) {
+          if (rawValue > thresholds[i]) {
+            aboveCounts[cell * thresholds.length + i]++;
+          }
+        }
+      });
+      years.accumulate(sums);
+      years.accumulate(counts, 1);
+      years.accumulate(aboveCounts, thresholds.length);
+      result.sums[type.ordinal()] = sums;
+      result.counts[type.ordinal()] = counts;
+      result.aboveCounts[type.ordinal()] = aboveCounts;
+    }
+    return result;
+  }
+
+  /** The raw thresholds of the given type, indexed by the threshold index of countAbove(). */
+  public int[] thresholds(Type type) {
+    return thresholds[type.ordinal()].clone();
+  }
+
+  /** Number of values of the given type in the years [firstYear, lastYear] and month set. */
+  public int count(Type type, int firstYear, int lastYear, int monthSet) {
+    final int[] counts = this.counts[type.ordinal()];
+    final int beginRow = years.beginRow(firstYear);
+    final int endRow = years.endRow(lastYear);
+    if (counts == null || beginRow >= endRow) {
+      return 0;
+    }
+    int result = 0;
+    for (int months = monthSet & ALL_MONTHS; months != 0; months &= months - 1) {
+      final int month = Integer.numberOfTrailingZeros(months);
+      result += counts[endRow * MONTHS + month] - counts[beginRow * MONTHS + month];
+    }
+    return result;
+  }
+
+  /** Sum, in the type's units, of the values of the given type in the years and month set. */
+  public double sum(Type type, int firstYear, int lastYear, int monthSet) {
+    final long[] sums = this.sums[type.ordinal()];
+    final int beginRow = years.beginRow(firstYear);
+    final int endRow = years.endRow(lastYear);
+    if (sums == null || beginRow >= endRow) {
+      return 0;
+    }
+    long result = 0;
+    for (int months = monthSet & ALL_MONTHS; months != 0; months &= months - 1) {
+      final int month = Integer.numberOfTrailingZeros(months);
+      result += sums[endRow * MONTHS + month] - sums[beginRow * MONTHS + month];
+    }
+    return type.scaleSum(result);
+  }
+
+  /** Mean, in the type's units, of the values of the given type in the years and month set. NaN if none. */
+  public double mean(Type type, int firstYear, int lastYear, int monthSet) {
+    final int count = count(type, firstYear, lastYear, monthSet);
+    return count == 0 ? Double.NaN : sum(type, firstYear, lastYear, monthSet) / count;
+  }
+
+  /**
+   * Number of values of the given type above the raw threshold with the given index (see
+   * thresholds()), in the years [firstYear, lastYear] and month set.
+   */
+  public int countAbove(Type type, int thresholdIndex, int firstYear, int lastYear, int monthSet) {
+    final int numThresholds = thresholds[type.ordinal()].length;
+    if (thresholdIndex < 0 || thresholdIndex >= numThresholds) {
+      throw new IllegalArgumentException("Invalid threshold index of " + type + ": " + thresholdIndex);
+    }
+    final int[] aboveCounts = this.aboveCounts[type.ordinal()];
+    final int beginRow = years.beginRow(firstYear);
+    final int endRow = years.endRow(lastYear);
+    if (aboveCounts == null || beginRow >= endRow) {
+      return 0;
+    }
+    int result = 0;
+    for (int months = monthSet & ALL_MONTHS; months != 0; months &= months - 1) {
+      final int month = Integer.numberOfTrailingZeros(months);
+      result += aboveCounts[(endRow * MONTHS + month) * numThresholds + thresholdIndex]
+          - aboveCounts[(beginRow * MONTHS + month) * numThresholds + thresholdIndex];
+    }
+    return result;
+  }
+}
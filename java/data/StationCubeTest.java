@@ -0,0 +1,71 @@
+package data;
+
+import data.DataRecord.Type;
+import org.junit.Test;
+
+import java.util.Collections;
+import java.util.EnumMap;
+import java.util.Map;
+
+import static data.TestData.record;
+import static org.junit.Assert.*;
+
+public class StationCubeTest {
+
+  private static final double DELTA = 1e-4;
+
+  private static StationCube cube() {
+    final StationSeries series = new StationSeries("USC00000001");
+    for (int year = 1990; year <= 1999; year++) {
+      for (int month = 1; month <= 12; month++) {
+        // TMAX is month * 10 C in odd years and 0 C in even years.
+        series.add(record(year, month, Type.TMAX, year % 2 == 1 ? month * 100 : 0));
+      }
+    }
+    final Map<Type, int[]> thresholds = new EnumMap<>(Type.class);
+    thresholds.put(Type.TMAX, new int[] {0, 350});
+    return StationCube.compute(series, thresholds);
+  }
+
+  @Test
+  public void testCountAndMean() {
+    final StationCube cube = cube();
+    final int summer = StationCube.monthSet(6, 7, 8);
+    assertEquals(92 * 10, cube.count(Type.TMAX, 1990, 1999, summer));
+    assertEquals(92 * 2, cube.count(Type.TMAX, 1991, 1992, summer));
+    assertEquals(30, cube.mean(Type.TMAX, 1991, 1991, StationCube.monthSet(3)), DELTA);
+    assertEquals(15, cube.mean(Type.TMAX, 1990, 1991, StationCube.monthSet(3)), DELTA);
+    assertEquals(31 * 10 + 28 * 20, cube.sum(Type.TMAX, 1991, 1991, StationCube.monthSet(1, 2)), DELTA);
+    // Clamped to 1990-1999, with two leap years.
+    assertEquals(365 * 10 + 2, cube.count(Type.TMAX, 1900, 2100, StationCube.ALL_MONTHS));
+    assertEquals(0, cube.count(Type.TMAX, 1990, 1999, 0));
+    assertEquals(0, cube.count(Type.TMAX, 1999, 1990, StationCube.ALL_MONTHS));
+    assertEquals(0, cube.count(Type.TMIN, 1990, 1999, StationCube.ALL_MONTHS));
+    assertTrue(Double.isNaN(cube.mean(Type.TMIN, 1990, 1999, StationCube.ALL_MONTHS)));
+  }
+
+  @Test
+  public void testCountAbove() {
+    final StationCube cube = cube();
+    assertArrayEquals(new int[] {0, 350}, cube.thresholds(Type.TMAX));
+    // Above 0 C: all the days of the odd years.
+    assertEquals(365 * 5, cube.countAbove(Type.TMAX, 0, 1990, 1999, StationCube.ALL_MONTHS));
+    // Above 35 C: April to December of the odd years.
+    assertEquals(30 + 31 + 30, cube.countAbove(Type.TMAX, 1, 1993, 1993, StationCube.monthSet(4, 5, 6)));
+    assertEquals(0, cube.countAbove(Type.TMAX, 1, 1993, 1993, StationCube.monthSet(1, 2, 3)));
+    assertEquals(0, cube.countAbove(Type.TMAX, 1, 1994, 1994, StationCube.monthSet(4, 5, 6)));
+  }
+
+  @Test(expected = IllegalArgumentException.class)
+  public void testInvalidThreshold() {
+    cube().countAbove(Type.TMIN, 0, 1990, 1999, StationCube.ALL_MONTHS);
+  }
+
+  @Test
+  public void testEmpty() {
+    final StationCube cube = StationCube.compute(new StationSeries("USC00000001"),
+        Collections.singletonMap(Type.TMAX, new int[] {0}));
+    assertEquals(0, cube.count(Type.TMAX, 1900, 2000, StationCube.ALL_MONTHS));
+    assertEquals(0, cube.countAbove(Type.TMAX, 0, 1900, 2000, StationCube.ALL_MONTHS));
+  }
+}
@@ -0,0 +1,81 @@
+package data;
+
+import geo.GeoBox;
+
+import java.util.BitSet;
+
+/**
+ * A spatial index of the stations of a StationRegistry: a fixed grid of one degree cells,
+ * with the indexes of the stations of each cell stored contiguously. Finding the stations
+ * in a bounding box visits only the cells that overlap it.
+ */
+public class StationGrid {
+  private static final int ROWS = 180;
+  private static final int COLUMNS = 360;
+
+  private final StationRegistry registry;
+
+  // The station indexes of cell c are stationIndexes[cellStart[c], cellStart[c + 1]), in
+  // increasing order.
+  private final int[] cellStart = new int[ROWS * COLUMNS + 1];
+  private final int[] stationIndexes;
+
+  public StationGrid(StationRegistry registry) {
+    this.registry = registry;
+    final int size = registry.size();
+    final int[] cells = new int[size];
+    for (int index = 0; index < size; index++) {
+      cells[index] = cellOf(registry.latitude(index), registry.longitude(index));
+      cellStart[cells[index] + 1]++;
+    }
+    for (int cell = 0; cell < ROWS * COLUMNS; cell++) {
+      cellStart[cell + 1] += cellStart[cell];
+    }
+    stationIndexes = new int[size];
+    final int[] next = new int[ROWS * COLUMNS];
+    System.arraycopy(cellStart, 0, next, 0, next.length);
+    for (int index = 0; index < size; index++) {
+      stationIndexes[next[cells[index]]++] = index;
+    }
+  }
+
+  /** Sets in result the indexes of the stations that are in the given box. */
+  public void findStations(GeoBox box, BitSet result) {
+    final int firstRow = row(box.minLat);
+    final int lastRow = row(box.maxLat);
+    if (box.crossesAntimeridian()) {
+      findStations(box, firstRow, lastRow, column(box.minLon), COLUMNS - 1, result);
+      findStations(box, firstRow, lastRow, 0, column(box.maxLon), result);
+    } else {
+      findStations(box, firstRow, lastRow, column(box.minLon), column(box.maxLon), result);
+    }
+  }
+
+  private void findStations(GeoBox box, int firstRow, int lastRow, int firstColumn,
+                            int lastColumn, BitSet result) {
+    for (int row = firstRow; row <= lastRow; row++) {
+      for (int column = firstColumn; column <= lastColumn; column++) {
+        final int cell = row * COLUMNS + column;
+        for (int i = cellStart[cell]; i < cellStart[cell + 1]; i++) {
+          final int index = stationIndexes[i];
+          if (box.contains(registry.latitude(index), registry.longitude(index))) {
+            result.set(index);
+          }
+        }
+      }
+    }
+  }
+
+  private static int cellOf(double lat, double lon) {
+    return row(lat) * COLUMNS + column(lon);
+  }
+
+  // Out of range coordinates are clamped to the edge cells.
+  private static int row(double lat) {
+    return Math.max(0, Math.min(ROWS - 1, (int) Math.floor(lat + 90)));
+  }
+
+  private static int column(double lon) {
+    return Math.max(0, Math.min(COLUMNS - 1, (int) Math.floor(lon + 180)));
+  }
+}
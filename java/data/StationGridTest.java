@@ -0,0 +1,42 @@
+package data;
+
+import geo.GeoBox;
+import geo.GeoPoint;
+import org.junit.Test;
+
+import java.util.BitSet;
+
+import static data.TestData.registry;
+import static org.junit.Assert.*;
+
+public class StationGridTest {
+
+  @Test
+  public void testFindStations() throws Exception {
+    final StationRegistry registry = registry(
+        "USC00000001", "31.2361", "-94.7544",
+        "USC00000002", "35.4822", "-97.5350",
+        "USC00000003", "40.7127", "-74.0059",
+        "RSM00025563", "64.7333", "177.5000",
+        "USW00026411", "64.8156", "-147.8764");
+    assertEquals(5, registry.size());
+    assertEquals(2, registry.indexOf("USC00000003"));
+    assertEquals(-1, registry.indexOf("USC00000004"));
+    assertEquals("RS", registry.country(3));
+
+    final StationGrid grid = new StationGrid(registry);
+    final BitSet result = new BitSet();
+    grid.findStations(new GeoBox(30, -100, 36, -90), result);
+    assertEquals("{0, 1}", result.toString());
+
+    // Crosses the antimeridian.
+    result.clear();
+    grid.findStations(new GeoBox(60, 170, 70, -140), result);
+    assertEquals("{3, 4}", result.toString());
+
+    // 400km around Oklahoma City.
+    result.clear();
+    grid.findStations(GeoBox.around(new GeoPoint(35.48f, -97.53f), 400_000), result);
+    assertEquals("{1}", result.toString());
+  }
+}
@@ -6,21 +6,22 @@ import geo.GeoPoint;
  * Represents the a single station meatadata record read from the stations file.
  */
 public class StationRecord {
-  // The original textLine from the stations file.
-  public final String textLine;
+  // Index of the station in its StationRegistry, or -1 if not from a registry.
+  public final int index;
   // Station ID id. E.g. "USW00093901"
   public final String id;
   // Station's location.
   public final GeoPoint geoPoint;
   // Elevation in meters.
   public final float elevation;
-  // Two letters US state id such as "TX".
+  // Two letters US state id such as "TX". Some other countries, e.g. Canada, have their
+  // province codes here. Blank for the others.
   public final String state;
   // Station name. Free text.
   public final String name;
 
-  private StationRecord(String textLine, String id, GeoPoint geoPoint, float elevation, String state, String name) {
-    this.textLine = textLine;
+  StationRecord(int index, String id, GeoPoint geoPoint, float elevation, String state, String name) {
+    this.index = index;
     this.id = id;
     this.geoPoint = geoPoint;
     this.elevation = elevation;
@@ -28,10 +29,10 @@ public class StationRecord {
     this.name = name;
   }
 
+  /** Returns true if the line is a station record of any country, same as StationRegistry.load(). */
   public static boolean isAcceptedTextLine(String textLine) {
-    // TODO: expand support to non us stations.
     // TODO: explain rationale for rejecting station records shorter than 85 chars (copied from Heller).
-    return textLine.length() >= 85 && textLine.startsWith("US");
+    return textLine.length() >= 85 && StationRegistry.packStationId(textLine, 0) >= 0;
   }
 
   /**
@@ -47,18 +48,25 @@ public class StationRecord {
     // 0         1         2         3         4         5         6
     // US1COAR0087  39.6155 -104.7785 1780.9 CO CHERRY CREEK DAM 4.7 ESE
     final String code = textLine.substring(0, 11); // [0, 10]
-    final float lat = Float.valueOf(textLine.substring(11, 20));  // [11, 19]
-    final float lon = Float.valueOf(textLine.substring(21, 30));  // [21, 29]
+    final float lat = (float) Decimals.parse(textLine, 11, 20);  // [11, 19]
+    final float lon = (float) Decimals.parse(textLine, 21, 30);  // [21, 29]
     final GeoPoint geoPoint = new GeoPoint(lat, lon);
-    final float elevation = Float.valueOf(textLine.substring(30, 37));  // [30, 36]
+    final float elevation = (float) Decimals.parse(textLine, 30, 37);  // [30, 36]
     final String state = textLine.substring(38, 40);  // [38, 39]
     final String name = textLine.substring(41, 76).trim();  // [41, 75]
-    return new StationRecord(textLine, code, geoPoint, elevation, state, name);
+    return new StationRecord(-1, code, geoPoint, elevation, state, name);
   }
 
   @Override
   public String toString() {
-    return String.format("[%s] %s [%.1fm] [%s] [%s]", id, geoPoint, elevation, state, name);
+    final StringBuilder builder = new StringBuilder(80);
+    builder.append('[').append(id).append("] ");
+    // Same as geoPoint.toString(), with no String.format().
+    builder.append('[');
+    Decimals.appendFixed(builder, geoPoint.lat, 4).append(',');
+    Decimals.appendFixed(builder, geoPoint.lon, 4).append("] [");
+    Decimals.appendFixed(builder, elevation, 1).append("m] [");
+    return builder.append(state).append("] [").append(name).append(']').toString();
   }
 
   /**
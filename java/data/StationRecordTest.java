@@ -15,7 +15,10 @@ public class StationRecordTest {
     assertTrue(StationRecord.isAcceptedTextLine("USW00093987  31.2361  -94.7544   87.8" +
       " TX LUFKIN ANGELINA CO AP                       "));
     // Non "US"
-    assertFalse(StationRecord.isAcceptedTextLine("XSW00093987  31.2361  -94.7544   87.8" +
+    assertTrue(StationRecord.isAcceptedTextLine("CA001012010  48.3667 -123.4833   60.0" +
+      " BC BEAR CREEK                                  "));
+    // Invalid station id.
+    assertFalse(StationRecord.isAcceptedTextLine("usw00093987  31.2361  -94.7544   87.8" +
       " TX LUFKIN ANGELINA CO AP                       "));
   }
 
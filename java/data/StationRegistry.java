@@ -0,0 +1,242 @@
+package data;
+
+import geo.GeoPoint;
+
+import java.io.BufferedReader;
+import java.io.File;
+import java.io.FileReader;
+import java.io.IOException;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+
+/**
+ * The metadata of all the stations in the GHCN stations file, in compact parallel arrays
+ * indexed by a station index. Station ids are packed into 64 bit keys and looked up with a
+ * flat open addressing hash table, and the repeating state and country strings are interned.
+ * Scales to the full GHCN station list (~120K stations).
+ */
+public class StationRegistry {
+  // Length of a GHCN station id, e.g. "USW00093901".
+  private static final int STATION_ID_LENGTH = 11;
+  // Radix of the packed station id chars: 0 for none, then digits, then upper case letters.
+  private static final int ID_CHAR_RADIX = 37;
+
+  // Per station columns, indexed by station index, in stations file order.
+  private long[] keys;
+  private double[] latitudes;
+  private double[] longitudes;
+  private float[] elevations;
+  private short[] stateIds;
+  private short[] countryIds;
+  private String[] names;
+  private int size;
+
+  // Interned state and country strings, indexed by their ids.
+  private final List<String> states = new ArrayList<>();
+  private final List<String> countries = new ArrayList<>();
+
+  // Open addressing hash table from station key to station index + 1. Zero for empty slots.
+  private int[] table;
+
+  private StationRegistry(int capacity) {
+    keys = new long[capacity];
+    latitudes = new double[capacity];
+    longitudes = new double[capacity];
+    elevations = new float[capacity];
+    stateIds = new short[capacity];
+    countryIds = new short[capacity];
+    names = new String[capacity];
+  }
+
+  /**
+   * Loads the registry from a GHCN stations file. Lines that are too short or have an invalid
+   * station id are skipped.
+   */
+  public static StationRegistry load(File stationsFile) throws IOException {
+    final StationRegistry registry = new StationRegistry(1024);
+    final Map<String, Short> stateIds = new HashMap<>();
+    final Map<String, Short> countryIds = new HashMap<>();
+    try (BufferedReader reader = new BufferedReader(new FileReader(stationsFile))) {
+      String textLine;
+      while ((textLine = reader.readLine()) != null) {
+        // TODO: explain rationale for rejecting station records shorter than 85 chars (copied from Heller).
+        if (textLine.length() < 85) {
+          continue;
+        }
+        final long key = packStationId(textLine, 0);
+        if (key < 0) {
+          continue;
+        }
+        registry.add(key, textLine,
+            intern(textLine.substring(38, 40), registry.states, stateIds),
+            intern(textLine.substring(0, 2), registry.countries, countryIds));
+      }
+    }
+    registry.buildTable();
+    return registry;
+  }
+
+  // Appends a station parsed from a stations file line.
+  private void add(long key, String textLine, short stateId, short countryId) {
+    if (size == keys.length) {
+      final int capacity = size * 2;
+      keys = Arrays.copyOf(keys, capacity);
+      latitudes = Arrays.copyOf(latitudes, capacity);
+      longitudes = Arrays.copyOf(longitudes, capacity);
+      elevations = Arrays.copyOf(elevations, capacity);
+      stateIds = Arrays.copyOf(stateIds, capacity);
+      countryIds = Arrays.copyOf(countryIds, capacity);
+      names = Arrays.copyOf(names, capacity);
+    }
+    // 0         1         2         3         4         5         6
+    // US1COAR0087  39.6155 -104.7785 1780.9 CO CHERRY CREEK DAM 4.7 ESE
+    keys[size] = key;
+    latitudes[size] = Decimals.parse(textLine, 11, 20);  // [11, 19]
+    longitudes[size] = Decimals.parse(textLine, 21, 30);  // [21, 29]
+    elevations[size] = (float) Decimals.parse(textLine, 30, 37);  // [30, 36]
+    stateIds[size] = stateId;  // [38, 39]
+    countryIds[size] = countryId;
+    names[size] = textLine.substring(41, 76).trim();  // [41, 75]
+    size++;
+  }
+
+  private static short intern(String value, List<String> values, Map<String, Short> ids) {
+    Short id = ids.get(value);
+    if (id == null) {
+      id = (short) values.size();
+      ids.put(value, id);
+      values.add(value);
+    }
+    return id;
+  }
+
+  private void buildTable() {
+    int tableSize = 16;
+    while (tableSize < size * 2) {
+      tableSize *= 2;
+    }
+    table = new int[tableSize];
+    for (int index = 0; index < size; index++) {
+      int slot = slotOf(keys[index]);
+      while (table[slot] != 0) {
+        slot = (slot + 1) & (table.length - 1);
+      }
+      table[slot] = index + 1;
+    }
+  }
+
+  // The home slot of the key in the table. Package private for tests.
+  int slotOf(long key) {
+    // Fibonacci hashing of the key into the table's range.
+    final int bits = Integer.numberOfTrailingZeros(table.length);
+    return (int) ((key * 0x9E3779B97F4A7C15L) >>> (64 - bits));
+  }
+
+  /**
+   * Packs the 11 chars station id that starts at the given offset into a 64 bit key, as a
+   * base 37 number. Returns -1 if the id has chars other than digits and upper case letters.
+   */
+  public static long packStationId(CharSequence text, int offset) {
+    if (text.length() < offset + STATION_ID_LENGTH) {
+      return -1;
+    }
+    long key = 0;
+    for (int i = offset; i < offset + STATION_ID_LENGTH; i++) {
+      final char c = text.charAt(i);
+      final int digit;
+      if (c >= '0' && c <= '9') {
+        digit = c - '0' + 1;
+      } else if (c >= 'A' && c <= 'Z') {
+        digit = c - 'A' + 11;
+      } else {
+        return -1;
+      }
+      key = key * ID_CHAR_RADIX + digit;
+    }
+    return key;
+  }
+
+  /** Reverses packStationId(). */
+  public static String unpackStationId(long key) {
+    final char[] chars = new char[STATION_ID_LENGTH];
+    for (int i = STATION_ID_LENGTH - 1; i >= 0; i--) {
+      final int digit = (int) (key % ID_CHAR_RADIX);
+      chars[i] = (char) (digit <= 10 ? '0' + digit - 1 : 'A' + digit - 11);
+      key /= ID_CHAR_RADIX;
+    }
+    return new String(chars);
+  }
+
+  /** Number of stations. Station indexes are in the range [0, size()). */
+  public int size() {
+    return size;
+  }
+
+  /** Returns the index of the station with the given packed key or -1 if not found. */
+  public int indexOfKey(long key) {
+    if (key < 0) {
+      return -1;
+    }
+    for (int slot = slotOf(key); table[slot] != 0; slot = (slot + 1) & (table.length - 1)) {
+      final int index = table[slot] - 1;
+      if (keys[index] == key) {
+        return index;
+      }
+    }
+    return -1;
+  }
+
+  /** Returns the index of the station with the given id or -1 if not found. */
+  public int indexOf(CharSequence stationId) {
+    return stationId.length() == STATION_ID_LENGTH ? indexOfKey(packStationId(stationId, 0)) : -1;
+  }
+
+  public long key(int index) {
+    return keys[index];
+  }
+
+  public String stationId(int index) {
+    return unpackStationId(keys[index]);
+  }
+
+  public double latitude(int index) {
+    return latitudes[index];
+  }
+
+  public double longitude(int index) {
+    return longitudes[index];
+  }
+
+  /** Elevation in meters. */
+  public float elevation(int index) {
+    return elevations[index];
+  }
+
+  /**
+   * Two letters US state id such as "TX". Some other countries, e.g. Canada, have their
+   * province codes here. Blank for the others.
+   */
+  public String state(int index) {
+    return states.get(stateIds[index]);
+  }
+
+  /** Two letters country code, the first two chars of the station id. */
+  public String country(int index) {
+    return countries.get(countryIds[index]);
+  }
+
+  /** Station name. Free text. */
+  public String name(int index) {
+    return names[index];
+  }
+
+  /** Returns a StationRecord with the metadata of the station with the given index. */
+  public StationRecord stationRecord(int index) {
+    return new StationRecord(index, stationId(index),
+        new GeoPoint((float) latitudes[index], (float) longitudes[index]),
+        elevations[index], state(index), names[index]);
+  }
+}
@@ -0,0 +1,114 @@
+package data;
+
+import org.junit.Test;
+
+import java.util.ArrayList;
+import java.util.List;
+
+import static data.TestData.registry;
+import static org.junit.Assert.*;
+
+public class StationRegistryTest {
+
+  // The stations of the given ids, in that order.
+  private static StationRegistry registryOf(List<String> stationIds) throws Exception {
+    final String[] stations = new String[stationIds.size() * 3];
+    for (int i = 0; i < stationIds.size(); i++) {
+      stations[i * 3] = stationIds.get(i);
+      stations[i * 3 + 1] = "31.2361";
+      stations[i * 3 + 2] = "-94.7544";
+    }
+    return registry(stations);
+  }
+
+  // Returns the first count ids "USCnnnnnnnn", from startNumber on, whose home slot in the
+  // table of the given registry is the given slot.
+  private static List<String> idsInSlot(StationRegistry registry, int slot, int startNumber, int count) {
+    final List<String> result = new ArrayList<>();
+    for (int number = startNumber; result.size() < count; number++) {
+      final String stationId = String.format("USC%08d", number);
+      if (registry.slotOf(StationRegistry.packStationId(stationId, 0)) == slot) {
+        result.add(stationId);
+      }
+    }
+    return result;
+  }
+
+  @Test
+  public void testPackAndUnpack() {
+    for (String stationId : new String[] {"USW00093901", "US1COAR0087", "RSM00025563", "CA001012010"}) {
+      final long key = StationRegistry.packStationId(stationId, 0);
+      assertTrue(stationId, key >= 0);
+      assertEquals(stationId, StationRegistry.unpackStationId(key));
+    }
+    // Ids inside a longer text, such as a .dly line.
+    assertEquals(StationRegistry.packStationId("USW00093901", 0),
+        StationRegistry.packStationId("xxUSW00093901195001TMAX", 2));
+    assertNotEquals(StationRegistry.packStationId("USW00093901", 0),
+        StationRegistry.packStationId("USW00093902", 0));
+  }
+
+  @Test
+  public void testExtremeIds() {
+    // All the chars with the min and max digit, including the max key.
+    long maxKey = 0;
+    for (int i = 0; i < 11; i++) {
+      maxKey = maxKey * 37 + 36;
+    }
+    assertEquals(maxKey, StationRegistry.packStationId("ZZZZZZZZZZZ", 0));
+    assertTrue(maxKey > 0);
+    for (String stationId : new String[] {"ZZZZZZZZZZZ", "00000000000", "99999999999", "AAAAAAAAAAA", "Z0Z0Z0Z0Z09"}) {
+      assertEquals(stationId, StationRegistry.unpackStationId(StationRegistry.packStationId(stationId, 0)));
+    }
+  }
+
+  @Test
+  public void testInvalidIds() throws Exception {
+    assertEquals(-1, StationRegistry.packStationId("usw00093901", 0));
+    assertEquals(-1, StationRegistry.packStationId("USW-0093901", 0));
+    assertEquals(-1, StationRegistry.packStationId("USW0009390 ", 0));
+    assertEquals(-1, StationRegistry.packStationId("USW0009390", 0));
+    assertEquals(-1, StationRegistry.packStationId("USW00093901", 1));
+
+    // Lines with invalid ids are skipped.
+    final StationRegistry registry = registry(
+        "USC00000001", "31.2361", "-94.7544",
+        "USC-0000002", "35.4822", "-97.5350",
+        "USC00000003", "40.7127", "-74.0059");
+    assertEquals(2, registry.size());
+    assertEquals("USC00000003", registry.stationId(1));
+    assertEquals(-1, registry.indexOf("USC-0000002"));
+    assertEquals(-1, registry.indexOf("USC0000000"));
+    assertEquals(-1, registry.indexOf("USC000000011"));
+    assertEquals(-1, registry.indexOfKey(-1));
+  }
+
+  @Test
+  public void testCollidingLookups() throws Exception {
+    // Registries of up to 8 stations have the same table size, hence the same home slots.
+    final List<String> probeIds = new ArrayList<>();
+    for (int i = 0; i < 8; i++) {
+      probeIds.add(String.format("USC%08d", i));
+    }
+    final StationRegistry probe = registryOf(probeIds);
+
+    // Four ids in the last slot, which wrap around to the first slots, then three ids whose
+    // home slot is taken by them.
+    final List<String> lastSlotIds = idsInSlot(probe, 15, 0, 5);
+    final List<String> stationIds = new ArrayList<>(lastSlotIds.subList(0, 4));
+    final List<String> slot2Ids = idsInSlot(probe, 2, 0, 4);
+    stationIds.addAll(slot2Ids.subList(0, 3));
+    final StationRegistry registry = registryOf(stationIds);
+
+    assertEquals(7, registry.size());
+    for (int index = 0; index < stationIds.size(); index++) {
+      final String stationId = stationIds.get(index);
+      assertEquals(index < 4 ? 15 : 2, registry.slotOf(registry.key(index)));
+      assertEquals(stationId, index, registry.indexOf(stationId));
+      assertEquals(stationId, registry.stationId(index));
+    }
+    // Missing ids whose probes go over the occupied slots.
+    assertEquals(-1, registry.indexOf(lastSlotIds.get(4)));
+    assertEquals(-1, registry.indexOf(slot2Ids.get(3)));
+  }
+}
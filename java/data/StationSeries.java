@@ -0,0 +1,297 @@
+package data;
+
+import data.DataRecord.Type;
+
+import java.time.LocalDate;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+
+/**
+ * A compact, columnar store of the daily values of a single station. Each data type has a
+ * contiguous array of raw values (e.g. tenth of C) indexed by days since Jan 1st of the
+ * station's first year, and a bitmap of the days that have a value. This takes about 2 bytes
+ * per day and type, compared to a DataRecord per month and type.
+ *
+ * <p>Filled by calling add() with the records of the station, in any order.</p>
+ */
+public class StationSeries {
+  private static final int NUMBER_OF_TYPES = Type.values().length;
+
+  // Raw values outside of this range can't be stored and are treated as missing. This
+  // is well above the valid range of all the supported types.
+  private static final int MIN_RAW_VALUE = Short.MIN_VALUE;
+  private static final int MAX_RAW_VALUE = Short.MAX_VALUE;
+
+  // Station ID id. E.g. "USW00093901"
+  public final String stationId;
+  // The station id packed with StationRegistry.packStationId(). Same as DataRecord.stationKey.
+  public final long stationKey;
+
+  // Years range [firstYear, endYear). Empty if firstYear == endYear.
+  private int firstYear;
+  private int endYear;
+
+  // Epoch day of Jan 1st of firstYear. Day indexes are relative to this day.
+  private long firstEpochDay;
+
+  // Number of days in the years range.
+  private int numDays;
+
+  // Per type raw values and validity bitmap, indexed by Type.ordinal(). Null for types
+  // with no values. Arrays may have spare capacity beyond numDays.
+  private final short[][] values = new short[NUMBER_OF_TYPES][];
+  private final long[][] validBits = new long[NUMBER_OF_TYPES][];
+
+  public StationSeries(String stationId) {
+    this.stationId = stationId;
+    this.stationKey = StationRegistry.packStationId(stationId, 0);
+  }
+
+  // Constructs a series from its internal arrays. Used when loading from a binary file.
+  StationSeries(String stationId, int firstYear, int endYear, short[][] values, long[][] validBits) {
+    this.stationId = stationId;
+    this.stationKey = StationRegistry.packStationId(stationId, 0);
+    if (firstYear != endYear) {
+      setRange(firstYear, endYear);
+    }
+    for (int type = 0; type < NUMBER_OF_TYPES; type++) {
+      this.values[type] = values[type];
+      this.validBits[type] = validBits[type];
+    }
+  }
+
+  /** Adds the values of a data record of this station. */
+  public void add(DataRecord data) {
+    ensureYear(data.year);
+    final int type = data.type.ordinal();
+    if (values[type] == null) {
+      values[type] = new short[numDays];
+      validBits[type] = new long[bitsWords(numDays)];
+    }
+    final int monthStart = dayIndex(data.year, data.month, 1);
+    final int daysInMonth = daysInMonth(data.year, data.month);
+    for (int i = 0; i < daysInMonth; i++) {
+      final int rawValue = data.rawValues[i];
+      if (rawValue != DataRecord.MISSING_VALUE && rawValue >= MIN_RAW_VALUE && rawValue <= MAX_RAW_VALUE) {
+        set(type, monthStart + i, rawValue);
+      }
+    }
+  }
+
+  /** Releases spare capacity. Call once all the records were added. */
+  public void trimToSize() {
+    for (int type = 0; type < NUMBER_OF_TYPES; type++) {
+      if (values[type] != null && values[type].length > numDays) {
+        values[type] = Arrays.copyOf(values[type], numDays);
+        validBits[type] = Arrays.copyOf(validBits[type], bitsWords(numDays));
+      }
+    }
+  }
+
+  public boolean isEmpty() {
+    return firstYear == endYear;
+  }
+
+  /** First year with data. Call only if not empty. */
+  public int firstYear() {
+    return firstYear;
+  }
+
+  /** Last year with data, inclusive. Call only if not empty. */
+  public int lastYear() {
+    return endYear - 1;
+  }
+
+  /** Number of days from Jan 1st of firstYear() to Dec 31th of lastYear(), inclusive. */
+  public int numDays() {
+    return numDays;
+  }
+
+  /** Returns true if there is at least one value of the given type. */
+  public boolean hasType(Type type) {
+    return values[type.ordinal()] != null;
+  }
+
+  /**
+   * Returns the index of the given date. The index is valid only if the year is in
+   * the range [firstYear(), lastYear()] and the day exists in the month.
+   */
+  public int dayIndex(int year, int month, int day) {
+    return (int) (LocalDate.of(year, month, 1).toEpochDay() - firstEpochDay) + day - 1;
+  }
+
+  /** Returns true if the given type has a value on the day with the given index. */
+  public boolean hasValue(Type type, int dayIndex) {
+    final long[] bits = validBits[type.ordinal()];
+    return bits != null && dayIndex >= 0 && dayIndex < numDays
+        && (bits[dayIndex >>> 6] & (1L << dayIndex)) != 0;
+  }
+
+  /** Returns the raw value of the given type and day. Call only if hasValue() is true. */
+  public int rawValue(Type type, int dayIndex) {
+    return values[type.ordinal()][dayIndex];
+  }
+
+  /** Returns the value of the given type and day in the type's units. Call only if hasValue() is true. */
+  public float value(Type type, int dayIndex) {
+    return type.scale(rawValue(type, dayIndex));
+  }
+
+  /**
+   * Copies the raw values of the given month to rawValues, with the layout of
+   * DataRecord.rawValues. Days with no value are set to DataRecord.MISSING_VALUE.
+   *
+   * @param rawValues an array of at least DataRecord.MAX_DAYS_IN_MONTH entries.
+   * @return the number of days with a value.
+   */
+  public int monthValues(Type type, int year, int month, int[] rawValues) {
+    Arrays.fill(rawValues, 0, DataRecord.MAX_DAYS_IN_MONTH, DataRecord.MISSING_VALUE);
+    if (!hasType(type) || year < firstYear || year >= endYear) {
+      return 0;
+    }
+    int count = 0;
+    final int monthStart = dayIndex(year, month, 1);
+    final int daysInMonth = daysInMonth(year, month);
+    for (int i = 0; i < daysInMonth; i++) {
+      if (hasValue(type, monthStart + i)) {
+        rawValues[i] = rawValue(type, monthStart + i);
+        count++;
+      }
+    }
+    return count;
+  }
+
+  /** Callback interface of forEachValue(). */
+  public interface ValueConsumer {
+    void onValue(int year, int month, int day, int rawValue);
+  }
+
+  /** Calls the consumer with the raw values of the given type, in date order. */
+  public void forEachValue(Type type, ValueConsumer consumer) {
+    if (!hasType(type)) {
+      return;
+    }
+    int dayIndex = 0;
+    for (int year = firstYear; year < endYear; year++) {
+      for (int month = 1; month <= 12; month++) {
+        final int daysInMonth = daysInMonth(year, month);
+        for (int day = 1; day <= daysInMonth; day++, dayIndex++) {
+          if (hasValue(type, dayIndex)) {
+            consumer.onValue(year, month, day, rawValue(type, dayIndex));
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Reconstructs the data records of this series, ordered by year, month and type. Only
+   * months with at least one value of a type have a record for that type.
+   */
+  public List<DataRecord> toDataRecords() {
+    final List<DataRecord> result = new ArrayList<>();
+    if (isEmpty()) {
+      return result;
+    }
+    for (int year = firstYear; year < endYear; year++) {
+      for (int month = 1; month <= 12; month++) {
+        for (Type type : Type.values()) {
+          final int[] rawValues = new int[DataRecord.MAX_DAYS_IN_MONTH];
+          if (monthValues(type, year, month, rawValues) > 0) {
+            result.add(new DataRecord(stationKey, year, month, type, rawValues));
+          }
+        }
+      }
+    }
+    return result;
+  }
+
+  // The raw values array of the given type index, trimmed to numDays. For serialization.
+  short[] valuesArray(int type) {
+    trimToSize();
+    return values[type];
+  }
+
+  // The validity bitmap of the given type index, trimmed to numDays. For serialization.
+  long[] validBitsArray(int type) {
+    trimToSize();
+    return validBits[type];
+  }
+
+  public static int daysInMonth(int year, int month) {
+    return LocalDate.of(year, month, 1).lengthOfMonth();
+  }
+
+  private void set(int type, int dayIndex, int rawValue) {
+    values[type][dayIndex] = (short) rawValue;
+    validBits[type][dayIndex >>> 6] |= 1L << dayIndex;
+  }
+
+  // Makes sure that the years range includes the given year, reallocating as needed.
+  private void ensureYear(int year) {
+    if (isEmpty()) {
+      setRange(year, year + 1);
+      return;
+    }
+    if (year < firstYear) {
+      rebase(year);
+    } else if (year >= endYear) {
+      final int oldNumDays = numDays;
+      setRange(firstYear, year + 1);
+      for (int type = 0; type < NUMBER_OF_TYPES; type++) {
+        if (values[type] != null && values[type].length < numDays) {
+          // Grow with spare capacity since records are typically added in increasing years.
+          final int capacity = Math.max(numDays, oldNumDays + oldNumDays / 2);
+          values[type] = Arrays.copyOf(values[type], capacity);
+          validBits[type] = Arrays.copyOf(validBits[type], bitsWords(capacity));
+        }
+      }
+    }
+  }
+
+  // Moves the start of the years range to an earlier year. Rare, since records are
+  // typically added in increasing years.
+  private void rebase(int newFirstYear) {
+    final short[][] oldValues = values.clone();
+    final long[][] oldValidBits = validBits.clone();
+    final int oldNumDays = numDays;
+    final int shift = (int) (firstEpochDay - LocalDate.of(newFirstYear, 1, 1).toEpochDay());
+    setRange(newFirstYear, endYear);
+    for (int type = 0; type < NUMBER_OF_TYPES; type++) {
+      if (oldValues[type] == null) {
+        continue;
+      }
+      values[type] = new short[numDays];
+      validBits[type] = new long[bitsWords(numDays)];
+      for (int i = 0; i < oldNumDays; i++) {
+        if ((oldValidBits[type][i >>> 6] & (1L << i)) != 0) {
+          set(type, i + shift, oldValues[type][i]);
+        }
+      }
+    }
+  }
+
+  private void setRange(int firstYear, int endYear) {
+    this.firstYear = firstYear;
+    this.endYear = endYear;
+    this.firstEpochDay = LocalDate.of(firstYear, 1, 1).toEpochDay();
+    this.numDays = daysInYears(firstYear, endYear);
+  }
+
+  // Number of days in the years range [firstYear, endYear).
+  static int daysInYears(int firstYear, int endYear) {
+    return (int) (LocalDate.of(endYear, 1, 1).toEpochDay() - LocalDate.of(firstYear, 1, 1).toEpochDay());
+  }
+
+  private static int bitsWords(int numBits) {
+    return (numBits + 63) >>> 6;
+  }
+
+  /** For debugging. */
+  @Override
+  public String toString() {
+    return isEmpty() ? String.format("[%s] [empty]", stationId)
+        : String.format("[%s] [%d-%d]", stationId, firstYear, lastYear());
+  }
+}
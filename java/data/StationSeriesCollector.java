@@ -0,0 +1,40 @@
+package data;
+
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.List;
+
+/**
+ * A DataAnalyzer that loads the data of the selected stations into memory, as one compact
+ * StationSeries per station. Useful for analyses that need to scan the data of a station
+ * more than once.
+ */
+public class StationSeriesCollector extends DataAnalyzer {
+
+  private final List<StationSeries> seriesList = new ArrayList<>();
+
+  // The series of the current station.
+  private StationSeries currentSeries;
+
+  @Override
+  public void onStationStart(StationRecord station) {
+    currentSeries = new StationSeries(station.id);
+  }
+
+  @Override
+  public void onDataRecord(StationRecord station, DataRecord data) {
+    currentSeries.add(data);
+  }
+
+  @Override
+  public void onStationEnd(StationRecord station) {
+    currentSeries.trimToSize();
+    seriesList.add(currentSeries);
+    currentSeries = null;
+  }
+
+  /** The series of the stations, in the order they were processed. */
+  public List<StationSeries> getSeries() {
+    return Collections.unmodifiableList(seriesList);
+  }
+}
@@ -0,0 +1,133 @@
+package data;
+
+import com.sun.istack.internal.Nullable;
+
+import java.io.*;
+import java.nio.ByteBuffer;
+import java.nio.channels.FileChannel;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.nio.file.StandardCopyOption;
+import java.nio.file.StandardOpenOption;
+
+/**
+ * Reads and writes a StationSeries as a binary file, to skip the parsing of the station's
+ * .dly text file on later runs. The file records the size and modification time of the
+ * .dly file it was created from and is ignored once the .dly file changes.
+ *
+ * <p>Format (big endian): magic, format version, source file size, source file modification
+ * time, station id, first year, end year (exclusive), and for each Type a presence flag
+ * followed by the raw values and the validity bitmap of that type.</p>
+ */
+public class StationSeriesFile {
+  private static final int MAGIC = 0x47484e53;  // "GHNS"
+  // Increment when the format or the meaning of the stored values changes.
+  private static final int FORMAT_VERSION = 1;
+  // Max number of years of a series, to reject corrupted year ranges.
+  private static final int MAX_YEARS = 1000;
+
+  /**
+   * Writes the series to the given file. The file is written under a temporary name and
+   * renamed when complete so a partial file is never used.
+   *
+   * @param sourceFile the .dly file the series was parsed from.
+   */
+  public static void write(File file, StationSeries series, File sourceFile) throws IOException {
+    final File tmpFile = new File(file.getPath() + ".tmp");
+    try (DataOutputStream out = new DataOutputStream(new BufferedOutputStream(new FileOutputStream(tmpFile)))) {
+      out.writeInt(MAGIC);
+      out.writeInt(FORMAT_VERSION);
+      out.writeLong(sourceFile.length());
+      out.writeLong(sourceFile.lastModified());
+      out.writeUTF(series.stationId);
+      out.writeInt(series.isEmpty() ? 0 : series.firstYear());
+      out.writeInt(series.isEmpty() ? 0 : series.lastYear() + 1);
+      for (DataRecord.Type type : DataRecord.Type.values()) {
+        final short[] values = series.valuesArray(type.ordinal());
+        out.writeBoolean(values != null);
+        if (values == null) {
+          continue;
+        }
+        for (short value : values) {
+          out.writeShort(value);
+        }
+        for (long bits : series.validBitsArray(type.ordinal())) {
+          out.writeLong(bits);
+        }
+      }
+    }
+    Files.move(tmpFile.toPath(), file.toPath(), StandardCopyOption.REPLACE_EXISTING);
+  }
+
+  /**
+   * Reads a series from the given file.
+   *
+   * @param sourceFile the .dly file the series is expected to be parsed from.
+   * @return the series or null if the file doesn't exist, has a different format version, is
+   * truncated, or is out of date with respect to sourceFile.
+   */
+  @Nullable
+  public static StationSeries read(File file, File sourceFile) throws IOException {
+    if (!file.isFile()) {
+      return null;
+    }
+    final ByteBuffer buffer;
+    try (FileChannel channel = FileChannel.open(file.toPath(), StandardOpenOption.READ)) {
+      buffer = channel.map(FileChannel.MapMode.READ_ONLY, 0, channel.size());
+    }
+    if (buffer.remaining() < 24 || buffer.getInt() != MAGIC || buffer.getInt() != FORMAT_VERSION
+        || buffer.getLong() != sourceFile.length() || buffer.getLong() != sourceFile.lastModified()) {
+      return null;
+    }
+    // The rest is checked for truncation, e.g. by an interrupted run, and a truncated file
+    // is treated as out of date.
+    final String stationId = readUTF(buffer);
+    if (stationId == null || buffer.remaining() < 8) {
+      return null;
+    }
+    final int firstYear = buffer.getInt();
+    final int endYear = buffer.getInt();
+    if (firstYear < 0 || endYear < firstYear || endYear - firstYear > MAX_YEARS) {
+      return null;
+    }
+    final int numTypes = DataRecord.Type.values().length;
+    final short[][] values = new short[numTypes][];
+    final long[][] validBits = new long[numTypes][];
+    final int numDays = StationSeries.daysInYears(firstYear, endYear);
+    final int numBitsWords = (numDays + 63) >>> 6;
+    for (int type = 0; type < numTypes; type++) {
+      if (buffer.remaining() < 1) {
+        return null;
+      }
+      if (buffer.get() == 0) {
+        continue;
+      }
+      if (buffer.remaining() < numDays * 2 + numBitsWords * 8) {
+        return null;
+      }
+      values[type] = new short[numDays];
+      buffer.asShortBuffer().get(values[type]);
+      buffer.position(buffer.position() + numDays * 2);
+      validBits[type] = new long[numBitsWords];
+      buffer.asLongBuffer().get(validBits[type]);
+      buffer.position(buffer.position() + numBitsWords * 8);
+    }
+    return new StationSeries(stationId, firstYear, endYear, values, validBits);
+  }
+
+  // Reads a string written by DataOutput.writeUTF(), or returns null if truncated. Station
+  // ids are plain ASCII, for which the modified UTF-8 of writeUTF() is the same as UTF-8.
+  @Nullable
+  private static String readUTF(ByteBuffer buffer) {
+    if (buffer.remaining() < 2) {
+      return null;
+    }
+    final int length = buffer.getShort() & 0xffff;
+    if (buffer.remaining() < length) {
+      return null;
+    }
+    final byte[] bytes = new byte[length];
+    buffer.get(bytes);
+    return new String(bytes, StandardCharsets.UTF_8);
+  }
+}
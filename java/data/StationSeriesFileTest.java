@@ -0,0 +1,115 @@
+package data;
+
+import data.DataRecord.Type;
+import org.junit.Test;
+
+import java.io.File;
+import java.io.FileOutputStream;
+import java.io.RandomAccessFile;
+import java.nio.file.Files;
+
+import static org.junit.Assert.*;
+
+public class StationSeriesFileTest {
+
+  private static File tempFile(String suffix) throws Exception {
+    final File file = File.createTempFile("test", suffix);
+    file.deleteOnExit();
+    return file;
+  }
+
+  // A .dly source file with the given content.
+  private static File sourceFile(String content) throws Exception {
+    final File file = tempFile(".dly");
+    try (FileOutputStream out = new FileOutputStream(file)) {
+      out.write(content.getBytes("US-ASCII"));
+    }
+    return file;
+  }
+
+  private static StationSeries series() {
+    final StationSeries series = new StationSeries("USC00000001");
+    for (int year = 1999; year <= 2001; year++) {
+      final int[] rawValues = new int[DataRecord.MAX_DAYS_IN_MONTH];
+      for (int day = 0; day < rawValues.length; day++) {
+        rawValues[day] = day % 3 == 0 ? DataRecord.MISSING_VALUE : year - 2000 + day;
+      }
+      series.add(new DataRecord(series.stationKey, year, 2, Type.TMAX, rawValues));
+    }
+    return series;
+  }
+
+  @Test
+  public void testRoundTrip() throws Exception {
+    final File file = tempFile(".series");
+    final File source = sourceFile("data");
+    final StationSeries series = series();
+    StationSeriesFile.write(file, series, source);
+    final StationSeries result = StationSeriesFile.read(file, source);
+    assertNotNull(result);
+    assertEquals("USC00000001", result.stationId);
+    assertEquals(1999, result.firstYear());
+    assertEquals(2001, result.lastYear());
+    assertFalse(result.hasType(Type.TMIN));
+    assertEquals(series.toDataRecords().size(), result.toDataRecords().size());
+    for (int i = 0; i < series.numDays(); i++) {
+      assertEquals(series.hasValue(Type.TMAX, i), result.hasValue(Type.TMAX, i));
+      if (series.hasValue(Type.TMAX, i)) {
+        assertEquals(series.rawValue(Type.TMAX, i), result.rawValue(Type.TMAX, i));
+      }
+    }
+  }
+
+  @Test
+  public void testEmptySeries() throws Exception {
+    final File file = tempFile(".series");
+    final File source = sourceFile("");
+    StationSeriesFile.write(file, new StationSeries("USC00000001"), source);
+    final StationSeries result = StationSeriesFile.read(file, source);
+    assertNotNull(result);
+    assertTrue(result.isEmpty());
+  }
+
+  @Test
+  public void testMissingFile() throws Exception {
+    assertNull(StationSeriesFile.read(new File("/nonexistent/test.series"), sourceFile("data")));
+  }
+
+  @Test
+  public void testSourceSizeChanged() throws Exception {
+    final File file = tempFile(".series");
+    final File source = sourceFile("data");
+    StationSeriesFile.write(file, series(), source);
+    final long lastModified = source.lastModified();
+    try (FileOutputStream out = new FileOutputStream(source, true)) {
+      out.write('x');
+    }
+    assertTrue(source.setLastModified(lastModified));
+    assertNull(StationSeriesFile.read(file, source));
+  }
+
+  @Test
+  public void testSourceModificationTimeChanged() throws Exception {
+    final File file = tempFile(".series");
+    final File source = sourceFile("data");
+    StationSeriesFile.write(file, series(), source);
+    assertTrue(source.setLastModified(source.lastModified() - 60000));
+    assertNull(StationSeriesFile.read(file, source));
+  }
+
+  @Test
+  public void testTruncatedFile() throws Exception {
+    final File file = tempFile(".series");
+    final File source = sourceFile("data");
+    StationSeriesFile.write(file, series(), source);
+    final byte[] bytes = Files.readAllBytes(file.toPath());
+    // Every length short of the full file, e.g. after an interrupted write.
+    for (int length = 0; length < bytes.length; length++) {
+      try (RandomAccessFile out = new RandomAccessFile(file, "rw")) {
+        out.setLength(0);
+        out.write(bytes, 0, length);
+      }
+      assertNull("length " + length, StationSeriesFile.read(file, source));
+    }
+  }
+}
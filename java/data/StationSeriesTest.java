@@ -0,0 +1,206 @@
+package data;
+
+import data.DataRecord.Type;
+import org.junit.Test;
+
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.List;
+import java.util.Random;
+
+import static org.junit.Assert.*;
+
+public class StationSeriesTest {
+
+  private static final String STATION_ID = "USC00000001";
+
+  // A record with the value base + day on each day of the month, and 1 day out of 3 missing.
+  private static DataRecord record(int year, int month, Type type, int base) {
+    final int[] rawValues = new int[DataRecord.MAX_DAYS_IN_MONTH];
+    for (int i = 0; i < DataRecord.MAX_DAYS_IN_MONTH; i++) {
+      rawValues[i] = (i % 3 == 2) ? DataRecord.MISSING_VALUE : base + i + 1;
+    }
+    return new DataRecord(StationRegistry.packStationId(STATION_ID, 0), year, month, type, rawValues);
+  }
+
+  // Asserts that the series has the values of record(year, month, type, base).
+  private static void assertMonth(StationSeries series, int year, int month, Type type, int base) {
+    final int daysInMonth = StationSeries.daysInMonth(year, month);
+    for (int day = 1; day <= daysInMonth; day++) {
+      final String date = year + "-" + month + "-" + day;
+      final int dayIndex = series.dayIndex(year, month, day);
+      if (day % 3 == 0) {
+        assertFalse(date, series.hasValue(type, dayIndex));
+      } else {
+        assertTrue(date, series.hasValue(type, dayIndex));
+        assertEquals(date, base + day, series.rawValue(type, dayIndex));
+      }
+    }
+  }
+
+  private static void assertRecordsEqual(List<DataRecord> expected, List<DataRecord> actual) {
+    assertEquals(expected.size(), actual.size());
+    for (int i = 0; i < expected.size(); i++) {
+      assertEquals(expected.get(i).stationKey, actual.get(i).stationKey);
+      assertEquals(expected.get(i).year, actual.get(i).year);
+      assertEquals(expected.get(i).month, actual.get(i).month);
+      assertEquals(expected.get(i).type, actual.get(i).type);
+      assertArrayEquals(expected.get(i).rawValues, actual.get(i).rawValues);
+    }
+  }
+
+  @Test
+  public void testEmpty() {
+    final StationSeries series = new StationSeries(STATION_ID);
+    assertTrue(series.isEmpty());
+    assertEquals(0, series.numDays());
+    assertFalse(series.hasType(Type.TMAX));
+    assertFalse(series.hasValue(Type.TMAX, 0));
+    assertTrue(series.toDataRecords().isEmpty());
+  }
+
+  @Test
+  public void testAddYearsAfter() {
+    final StationSeries series = new StationSeries(STATION_ID);
+    series.add(record(1950, 1, Type.TMAX, 100));
+    assertEquals(1950, series.firstYear());
+    assertEquals(1950, series.lastYear());
+    assertEquals(365, series.numDays());
+
+    series.add(record(1951, 12, Type.TMAX, 200));
+    // A type that first appears after the range grew.
+    series.add(record(1951, 6, Type.TMIN, 300));
+    // Several years after the range, more than the spare capacity of the previous growth.
+    series.add(record(1970, 3, Type.TMAX, 400));
+    assertEquals(1950, series.firstYear());
+    assertEquals(1970, series.lastYear());
+    assertEquals(StationSeries.daysInYears(1950, 1971), series.numDays());
+
+    assertMonth(series, 1950, 1, Type.TMAX, 100);
+    assertMonth(series, 1951, 12, Type.TMAX, 200);
+    assertMonth(series, 1951, 6, Type.TMIN, 300);
+    assertMonth(series, 1970, 3, Type.TMAX, 400);
+    assertFalse(series.hasValue(Type.TMAX, series.dayIndex(1960, 1, 1)));
+    assertFalse(series.hasValue(Type.TMIN, series.dayIndex(1950, 1, 1)));
+    assertFalse(series.hasType(Type.PRCP));
+
+    // Releasing the spare capacity keeps the values.
+    series.trimToSize();
+    assertMonth(series, 1950, 1, Type.TMAX, 100);
+    assertMonth(series, 1970, 3, Type.TMAX, 400);
+    assertFalse(series.hasValue(Type.TMAX, series.numDays()));
+  }
+
+  @Test
+  public void testAddYearsBefore() {
+    final StationSeries series = new StationSeries(STATION_ID);
+    series.add(record(1960, 5, Type.TMAX, 100));
+    series.add(record(1961, 12, Type.TMIN, 200));
+    // Rebases the values of both types.
+    series.add(record(1955, 2, Type.TMAX, 300));
+    assertEquals(1955, series.firstYear());
+    assertEquals(1961, series.lastYear());
+    assertEquals(StationSeries.daysInYears(1955, 1962), series.numDays());
+    assertMonth(series, 1960, 5, Type.TMAX, 100);
+    assertMonth(series, 1961, 12, Type.TMIN, 200);
+    assertMonth(series, 1955, 2, Type.TMAX, 300);
+
+    // A new type, a year inside the range, then rebasing again and growing after it.
+    series.add(record(1958, 7, Type.PRCP, 400));
+    series.add(record(1900, 1, Type.PRCP, 500));
+    series.add(record(1965, 1, Type.TMIN, 600));
+    assertEquals(1900, series.firstYear());
+    assertEquals(1965, series.lastYear());
+    assertMonth(series, 1960, 5, Type.TMAX, 100);
+    assertMonth(series, 1961, 12, Type.TMIN, 200);
+    assertMonth(series, 1955, 2, Type.TMAX, 300);
+    assertMonth(series, 1958, 7, Type.PRCP, 400);
+    assertMonth(series, 1900, 1, Type.PRCP, 500);
+    assertMonth(series, 1965, 1, Type.TMIN, 600);
+    assertFalse(series.hasValue(Type.TMAX, series.dayIndex(1900, 1, 1)));
+  }
+
+  @Test
+  public void testLeapYearFebruary() {
+    final StationSeries series = new StationSeries(STATION_ID);
+    // 1900 isn't a leap year, 2000 and 2004 are.
+    series.add(record(2000, 2, Type.TMAX, 100));
+    series.add(record(1900, 2, Type.TMAX, 200));
+    series.add(record(2004, 2, Type.TMAX, 300));
+    series.add(record(2004, 3, Type.TMAX, 400));
+    assertEquals(29, StationSeries.daysInMonth(2000, 2));
+    assertEquals(28, StationSeries.daysInMonth(1900, 2));
+    assertMonth(series, 2000, 2, Type.TMAX, 100);
+    assertMonth(series, 1900, 2, Type.TMAX, 200);
+    assertMonth(series, 2004, 2, Type.TMAX, 300);
+    assertMonth(series, 2004, 3, Type.TMAX, 400);
+    assertEquals(series.dayIndex(2004, 2, 29) + 1, series.dayIndex(2004, 3, 1));
+    assertEquals(series.dayIndex(1900, 2, 28) + 1, series.dayIndex(1900, 3, 1));
+    assertEquals(StationSeries.daysInYears(1900, 2005), series.numDays());
+
+    // The values of the days past the end of the month are ignored.
+    final int[] rawValues = new int[DataRecord.MAX_DAYS_IN_MONTH];
+    assertEquals(20, series.monthValues(Type.TMAX, 2000, 2, rawValues));
+    assertEquals(129, rawValues[28]);
+    assertEquals(DataRecord.MISSING_VALUE, rawValues[29]);
+    assertEquals(19, series.monthValues(Type.TMAX, 1900, 2, rawValues));
+    assertEquals(DataRecord.MISSING_VALUE, rawValues[28]);
+    assertFalse(series.hasValue(Type.TMAX, series.dayIndex(1900, 3, 1)));
+  }
+
+  @Test
+  public void testOutOfRangeValuesAreMissing() {
+    final StationSeries series = new StationSeries(STATION_ID);
+    final DataRecord data = record(1950, 1, Type.PRCP, 0);
+    data.rawValues[0] = 40000;
+    data.rawValues[1] = -40000;
+    data.rawValues[3] = Short.MAX_VALUE;
+    series.add(data);
+    assertFalse(series.hasValue(Type.PRCP, 0));
+    assertFalse(series.hasValue(Type.PRCP, 1));
+    assertEquals(Short.MAX_VALUE, series.rawValue(Type.PRCP, 3));
+  }
+
+  @Test
+  public void testToDataRecordsRoundTrip() {
+    final Random random = new Random(1);
+    final List<DataRecord> expected = new ArrayList<>();
+    for (int year = 1895; year <= 1905; year++) {
+      for (int month = 1; month <= 12; month++) {
+        // In the order of the result records.
+        for (Type type : Type.values()) {
+          if (type == Type.TAVG || random.nextInt(4) == 0) {
+            continue;
+          }
+          final DataRecord data = record(year, month, type, random.nextInt(1000) - 500);
+          // The records of the series have no values past the end of the month.
+          Arrays.fill(data.rawValues, StationSeries.daysInMonth(year, month),
+              DataRecord.MAX_DAYS_IN_MONTH, DataRecord.MISSING_VALUE);
+          expected.add(data);
+        }
+      }
+    }
+
+    // Added in any order, e.g. with years before and after the current range.
+    final List<DataRecord> shuffled = new ArrayList<>(expected);
+    Collections.shuffle(shuffled, random);
+    final StationSeries series = new StationSeries(STATION_ID);
+    for (DataRecord data : shuffled) {
+      series.add(data);
+    }
+    // A record with no values has no record in the result.
+    final int[] missing = new int[DataRecord.MAX_DAYS_IN_MONTH];
+    Arrays.fill(missing, DataRecord.MISSING_VALUE);
+    series.add(new DataRecord(series.stationKey, 1900, 1, Type.TAVG, missing));
+
+    final List<DataRecord> records = series.toDataRecords();
+    assertRecordsEqual(expected, records);
+
+    final StationSeries copy = new StationSeries(STATION_ID);
+    for (DataRecord data : records) {
+      copy.add(data);
+    }
+    assertRecordsEqual(expected, copy.toDataRecords());
+  }
+}
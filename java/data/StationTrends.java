@@ -0,0 +1,243 @@
+package data;
+
+import com.sun.istack.internal.Nullable;
+import data.DataRecord.Type;
+
+import java.util.Arrays;
+
+/**
+ * The linear trends of a single station, per month and element, over the years of the
+ * station's data. Each trend is the slope of the month's mean temperature over the years in
+ * which the month has at least MIN_DAYS_PER_MONTH values, estimated by least squares or by
+ * Theil-Sen.
+ */
+public class StationTrends {
+  public enum Estimator {
+    // Least squares regression.
+    OLS,
+    // Median of the pairwise slopes (see TheilSen), robust to outlier years. It has no
+    // standard error nor R^2, which are NaN.
+    THEIL_SEN
+  }
+
+  public enum Element {
+    // Daily max temperature.
+    TMAX,
+    // Daily min temperature.
+    TMIN,
+    // Anomaly of the daily mean temperature (TMAX + TMIN) / 2, on days that have both,
+    // relative to the station's mean of the month. The baseline shifts the regression
+    // line but not its slope, so the mean temperature itself is regressed.
+    ANOMALY;
+
+    private static final Element[] ELEMENTS = values();
+  }
+
+  private static final int MONTHS = 12;
+  // Number of trend slots, indexed by slot(element, month).
+  public static final int SLOTS = Element.ELEMENTS.length * MONTHS;
+
+  // Min number of values in a month for the month's mean to be used.
+  public static final int MIN_DAYS_PER_MONTH = 20;
+  // Min number of years with a monthly mean for a trend to be reported.
+  public static final int MIN_YEARS = 10;
+
+  // Station ID id. E.g. "USW00093901"
+  public final String stationId;
+
+  // Per slot, the number of years in the regression. For trends pooled over stations (see
+  // fromPooledRegressions()), the number of stations.
+  public final int[] years = new int[SLOTS];
+  // Per slot, the trend slope in C per century and its standard error, and the R^2 of the
+  // regression. NaN if there are less than MIN_YEARS years.
+  public final float[] slopes = new float[SLOTS];
+  public final float[] slopeErrors = new float[SLOTS];
+  public final float[] rSquared = new float[SLOTS];
+
+  public StationTrends(String stationId) {
+    this.stationId = stationId;
+    Arrays.fill(slopes, Float.NaN);
+    Arrays.fill(slopeErrors, Float.NaN);
+    Arrays.fill(rSquared, Float.NaN);
+  }
+
+  /** The slot of the given element and month (1 based). */
+  public static int slot(Element element, int month) {
+    return element.ordinal() * MONTHS + month - 1;
+  }
+
+  public static Element slotElement(int slot) {
+    return Element.ELEMENTS[slot / MONTHS];
+  }
+
+  public static int slotMonth(int slot) {
+    return slot % MONTHS + 1;
+  }
+
+  public boolean hasTrend(int slot) {
+    return !Float.isNaN(slopes[slot]);
+  }
+
+  /** The average of the monthly slopes of the element, or NaN if it has no trends. */
+  public double meanSlope(Element element) {
+    double sum = 0;
+    int count = 0;
+    for (int month = 1; month <= MONTHS; month++) {
+      final int slot = slot(element, month);
+      if (hasTrend(slot)) {
+        sum += slopes[slot];
+        count++;
+      }
+    }
+    return count == 0 ? Double.NaN : sum / count;
+  }
+
+  /** Computes the least squares trends of the given station data. */
+  public static StationTrends compute(StationSeries series) {
+    return compute(series, Estimator.OLS);
+  }
+
+  /** Computes the trends of the given station data with the given estimator. */
+  public static StationTrends compute(StationSeries series, Estimator estimator) {
+    return compute(series, estimator, newRegressions());
+  }
+
+  /**
+   * Computes the trends of the given station data with the given estimator. The least squares
+   * regressions of the monthly means are accumulated into the given regressions (see
+   * newRegressions()), whatever the estimator, e.g. for merging them over stations.
+   */
+  public static StationTrends compute(StationSeries series, Estimator estimator,
+      RegressionAccumulator[] regressions) {
+    final StationTrends result = new StationTrends(series.stationId);
+    if (series.isEmpty()) {
+      return result;
+    }
+    // Per slot, the years and monthly means in increasing years. Only Theil-Sen needs them.
+    final int maxYears = series.lastYear() - series.firstYear() + 1;
+    final double[][] pointYears = estimator == Estimator.THEIL_SEN ? new double[SLOTS][maxYears] : null;
+    final double[][] pointMeans = estimator == Estimator.THEIL_SEN ? new double[SLOTS][maxYears] : null;
+    final int[] tMax = new int[DataRecord.MAX_DAYS_IN_MONTH];
+    final int[] tMin = new int[DataRecord.MAX_DAYS_IN_MONTH];
+    final MonthStats monthStats = new MonthStats();
+    for (int year = series.firstYear(); year <= series.lastYear(); year++) {
+      for (int month = 1; month <= MONTHS; month++) {
+        final boolean hasTMax = series.monthValues(Type.TMAX, year, month, tMax) >= MIN_DAYS_PER_MONTH;
+        final boolean hasTMin = series.monthValues(Type.TMIN, year, month, tMin) >= MIN_DAYS_PER_MONTH;
+        if (hasTMax) {
+          monthStats.compute(tMax);
+          addPoint(regressions, pointYears, pointMeans, slot(Element.TMAX, month), year,
+              Type.TMAX.scaleSum(monthStats.sum) / monthStats.count);
+        }
+        if (hasTMin) {
+          monthStats.compute(tMin);
+          addPoint(regressions, pointYears, pointMeans, slot(Element.TMIN, month), year,
+              Type.TMIN.scaleSum(monthStats.sum) / monthStats.count);
+        }
+        if (hasTMax && hasTMin) {
+          long sum = 0;
+          int count = 0;
+          for (int i = 0; i < DataRecord.MAX_DAYS_IN_MONTH; i++) {
+            if (tMax[i] != DataRecord.MISSING_VALUE && tMin[i] != DataRecord.MISSING_VALUE) {
+              sum += tMax[i] + tMin[i];
+              count++;
+            }
+          }
+          if (count >= MIN_DAYS_PER_MONTH) {
+            addPoint(regressions, pointYears, pointMeans, slot(Element.ANOMALY, month), year,
+                Type.TMAX.scaleSum(sum) / (2 * count));
+          }
+        }
+      }
+    }
+    if (estimator == Estimator.OLS) {
+      return fromRegressions(series.stationId, regressions);
+    }
+    // The selected median doesn't depend on the seed.
+    final TheilSen theilSen = new TheilSen(0);
+    for (int slot = 0; slot < SLOTS; slot++) {
+      result.years[slot] = (int) regressions[slot].count();
+      if (result.years[slot] >= MIN_YEARS) {
+        result.slopes[slot] = (float) (theilSen.slope(pointYears[slot], pointMeans[slot], result.years[slot]) * 100);
+      }
+    }
+    return result;
+  }
+
+  /** The least squares trends of the given per slot regressions of a single station. */
+  public static StationTrends fromRegressions(String stationId, RegressionAccumulator[] regressions) {
+    final StationTrends result = new StationTrends(stationId);
+    for (int slot = 0; slot < SLOTS; slot++) {
+      final RegressionAccumulator regression = regressions[slot];
+      result.years[slot] = (int) Math.min(Integer.MAX_VALUE, regression.count());
+      if (regression.count() >= MIN_YEARS) {
+        result.slopes[slot] = (float) (regression.slope() * 100);
+        result.slopeErrors[slot] = (float) (regression.slopeStandardError() * 100);
+        result.rSquared[slot] = (float) regression.rSquared();
+      }
+    }
+    return result;
+  }
+
+  /**
+   * The least squares trends pooled over stations: per slot, the within station slope of the
+   * regressions of the given number of stations, merged with
+   * RegressionAccumulator.mergeWithinGroups(). Each station keeps its own level, so stations
+   * at different levels or covering different years don't bias the slope.
+   */
+  public static StationTrends fromPooledRegressions(String stationId,
+      RegressionAccumulator[] regressions, int[] stations) {
+    final StationTrends result = new StationTrends(stationId);
+    for (int slot = 0; slot < SLOTS; slot++) {
+      final RegressionAccumulator regression = regressions[slot];
+      result.years[slot] = stations[slot];
+      if (stations[slot] > 0) {
+        result.slopes[slot] = (float) (regression.slope() * 100);
+        result.slopeErrors[slot] = (float) (regression.slopeStandardError(stations[slot]) * 100);
+        result.rSquared[slot] = (float) regression.rSquared();
+      }
+    }
+    return result;
+  }
+
+  /** Returns SLOTS empty regressions, for compute() and fromRegressions(). */
+  public static RegressionAccumulator[] newRegressions() {
+    final RegressionAccumulator[] result = new RegressionAccumulator[SLOTS];
+    for (int slot = 0; slot < SLOTS; slot++) {
+      result[slot] = new RegressionAccumulator();
+    }
+    return result;
+  }
+
+  // Adds a monthly mean to the regression of the slot, and to its points if kept.
+  private static void addPoint(RegressionAccumulator[] regressions, @Nullable double[][] pointYears,
+      @Nullable double[][] pointMeans, int slot, int year, double mean) {
+    if (pointYears != null) {
+      final int i = (int) regressions[slot].count();
+      pointYears[slot][i] = year;
+      pointMeans[slot][i] = mean;
+    }
+    regressions[slot].add(year, mean);
+  }
+
+  /** Writes the header line of writeCsv(). */
+  public static void writeCsvHeader(BufferedTextWriter writer) {
+    writer.append("station, element, month, years, slope C/century, slope error, r2").newLine();
+  }
+
+  /** Writes a CSV line per slot that has a trend. */
+  public void writeCsv(BufferedTextWriter writer) {
+    for (int slot = 0; slot < SLOTS; slot++) {
+      if (!hasTrend(slot)) {
+        continue;
+      }
+      writer.append(stationId)
+          .append(", ").append(slotElement(slot).name())
+          .append(", ").appendPadded(slotMonth(slot), 2)
+          .append(", ").appendPadded(years[slot], 4)
+          .append(", ").appendFixed(slopes[slot], 3, 7)
+          .append(", ").appendFixed(slopeErrors[slot], 3, 6)
+          .append(", ").appendFixed(rSquared[slot], 3).newLine();
+    }
+  }
+}
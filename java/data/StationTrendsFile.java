@@ -0,0 +1,83 @@
+package data;
+
+import java.io.*;
+import java.nio.ByteBuffer;
+import java.nio.channels.FileChannel;
+import java.nio.file.Files;
+import java.nio.file.StandardCopyOption;
+import java.nio.file.StandardOpenOption;
+import java.util.ArrayList;
+import java.util.List;
+
+/**
+ * Reads and writes a table of StationTrends as a compact binary file.
+ *
+ * <p>Format (big endian): magic, format version, number of slots, number of stations, and
+ * per station the packed station id (see StationRegistry.packStationId()) followed by the
+ * years count (short), slope, slope error and R^2 (floats) of each slot.</p>
+ */
+public class StationTrendsFile {
+  private static final int MAGIC = 0x47484e54;  // "GHNT"
+  // Increment when the format or the meaning of the stored values changes.
+  private static final int FORMAT_VERSION = 1;
+  // Bytes per station: the packed station id, then per slot the years and three floats.
+  private static final int STATION_BYTES = 8 + StationTrends.SLOTS * (2 + 3 * 4);
+
+  /**
+   * Writes the trends to the given file. The file is written under a temporary name and
+   * renamed when complete so a partial file is never used.
+   */
+  public static void write(File file, List<StationTrends> trends) throws IOException {
+    final File tmpFile = new File(file.getPath() + ".tmp");
+    try (DataOutputStream out = new DataOutputStream(new BufferedOutputStream(new FileOutputStream(tmpFile)))) {
+      out.writeInt(MAGIC);
+      out.writeInt(FORMAT_VERSION);
+      out.writeInt(StationTrends.SLOTS);
+      out.writeInt(trends.size());
+      for (StationTrends stationTrends : trends) {
+        out.writeLong(StationRegistry.packStationId(stationTrends.stationId, 0));
+        for (int slot = 0; slot < StationTrends.SLOTS; slot++) {
+          out.writeShort(Math.min(Short.MAX_VALUE, stationTrends.years[slot]));
+          out.writeFloat(stationTrends.slopes[slot]);
+          out.writeFloat(stationTrends.slopeErrors[slot]);
+          out.writeFloat(stationTrends.rSquared[slot]);
+        }
+      }
+    }
+    Files.move(tmpFile.toPath(), file.toPath(), StandardCopyOption.REPLACE_EXISTING);
+  }
+
+  /**
+   * Reads the trends from the given file.
+   *
+   * @throws IOException if the file isn't a trends file of this version, or is truncated.
+   */
+  public static List<StationTrends> read(File file) throws IOException {
+    final ByteBuffer buffer;
+    try (FileChannel channel = FileChannel.open(file.toPath(), StandardOpenOption.READ)) {
+      buffer = channel.map(FileChannel.MapMode.READ_ONLY, 0, channel.size());
+    }
+    if (buffer.remaining() < 16 || buffer.getInt() != MAGIC || buffer.getInt() != FORMAT_VERSION
+        || buffer.getInt() != StationTrends.SLOTS) {
+      throw new IOException("Not a station trends file of version " + FORMAT_VERSION + ": " + file);
+    }
+    final int size = buffer.getInt();
+    // Checked before allocating anything, since a corrupt size could be anything.
+    if (size < 0 || (long) size * STATION_BYTES != buffer.remaining()) {
+      throw new IOException(String.format("Truncated or corrupt station trends file of %d stations: %s", size, file));
+    }
+    final List<StationTrends> result = new ArrayList<>(size);
+    for (int i = 0; i < size; i++) {
+      final StationTrends stationTrends =
+          new StationTrends(StationRegistry.unpackStationId(buffer.getLong()));
+      for (int slot = 0; slot < StationTrends.SLOTS; slot++) {
+        stationTrends.years[slot] = buffer.getShort();
+        stationTrends.slopes[slot] = buffer.getFloat();
+        stationTrends.slopeErrors[slot] = buffer.getFloat();
+        stationTrends.rSquared[slot] = buffer.getFloat();
+      }
+      result.add(stationTrends);
+    }
+    return result;
+  }
+}
@@ -0,0 +1,139 @@
+package data;
+
+import data.DataRecord.Type;
+import data.StationTrends.Element;
+import org.junit.Test;
+
+import java.io.File;
+import java.io.IOException;
+import java.io.RandomAccessFile;
+import java.nio.file.Files;
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.List;
+
+import static org.junit.Assert.*;
+
+public class StationTrendsTest {
+
+  private static final float DELTA = 1e-3f;
+
+  // A July record with the same raw value on all the days.
+  private static DataRecord julyRecord(int year, Type type, int rawValue) {
+    final int[] rawValues = new int[DataRecord.MAX_DAYS_IN_MONTH];
+    Arrays.fill(rawValues, rawValue);
+    return new DataRecord(StationRegistry.packStationId("USC00000001", 0), year, 7, type, rawValues);
+  }
+
+  private static StationSeries series(int firstYear, int lastYear) {
+    final StationSeries series = new StationSeries("USC00000001");
+    for (int year = firstYear; year <= lastYear; year++) {
+      // TMAX rises 2C per century, TMIN is flat.
+      series.add(julyRecord(year, Type.TMAX, 300 + (year - firstYear) / 5));
+      series.add(julyRecord(year, Type.TMIN, 150));
+    }
+    return series;
+  }
+
+  @Test
+  public void testCompute() {
+    final StationTrends trends = StationTrends.compute(series(1900, 1999));
+    final int tMaxSlot = StationTrends.slot(Element.TMAX, 7);
+    assertEquals(100, trends.years[tMaxSlot]);
+    assertEquals(2.0f, trends.slopes[tMaxSlot], 0.05f);
+    assertEquals(0f, trends.slopes[StationTrends.slot(Element.TMIN, 7)], DELTA);
+    assertEquals(1.0f, trends.slopes[StationTrends.slot(Element.ANOMALY, 7)], 0.05f);
+    assertFalse(trends.hasTrend(StationTrends.slot(Element.TMAX, 6)));
+    assertEquals(2.0, trends.meanSlope(Element.TMAX), 0.05);
+  }
+
+  @Test
+  public void testTheilSen() {
+    final StationSeries series = new StationSeries("USC00000001");
+    for (int year = 1900; year <= 1999; year++) {
+      // Flat TMAX but for a few hot years at the end.
+      series.add(julyRecord(year, Type.TMAX, year >= 1995 ? 400 : 300));
+    }
+    final int slot = StationTrends.slot(Element.TMAX, 7);
+    final StationTrends ols = StationTrends.compute(series, StationTrends.Estimator.OLS);
+    final StationTrends theilSen = StationTrends.compute(series, StationTrends.Estimator.THEIL_SEN);
+    assertTrue(ols.slopes[slot] > 1);
+    assertEquals(0f, theilSen.slopes[slot], DELTA);
+    assertEquals(100, theilSen.years[slot]);
+    assertTrue(Float.isNaN(theilSen.slopeErrors[slot]));
+  }
+
+  // A station with TMAX rising 10C per century from the given raw level in 1900.
+  private static StationSeries stationAtLevel(int level, int firstYear, int lastYear) {
+    final StationSeries series = new StationSeries("USC00000001");
+    for (int year = firstYear; year <= lastYear; year++) {
+      series.add(julyRecord(year, Type.TMAX, level + year - 1900));
+    }
+    return series;
+  }
+
+  @Test
+  public void testPooledRegressions() {
+    // A cold station with recent years and a warm one with older years.
+    final StationSeries[] stations = {stationAtLevel(100, 1950, 2017), stationAtLevel(300, 1900, 1950)};
+    final RegressionAccumulator[] pooled = StationTrends.newRegressions();
+    final RegressionAccumulator[] merged = StationTrends.newRegressions();
+    final int[] pooledStations = new int[StationTrends.SLOTS];
+    for (StationSeries series : stations) {
+      final RegressionAccumulator[] regressions = StationTrends.newRegressions();
+      StationTrends.compute(series, StationTrends.Estimator.THEIL_SEN, regressions);
+      for (int slot = 0; slot < StationTrends.SLOTS; slot++) {
+        if (regressions[slot].count() >= StationTrends.MIN_YEARS) {
+          pooled[slot].mergeWithinGroups(regressions[slot]);
+          merged[slot].merge(regressions[slot]);
+          pooledStations[slot]++;
+        }
+      }
+    }
+    final StationTrends trends = StationTrends.fromPooledRegressions("ALL", pooled, pooledStations);
+    final int tMaxSlot = StationTrends.slot(Element.TMAX, 7);
+    assertEquals(2, trends.years[tMaxSlot]);
+    assertEquals(10f, trends.slopes[tMaxSlot], DELTA);
+    assertEquals(0f, trends.slopeErrors[tMaxSlot], DELTA);
+    assertEquals(1f, trends.rSquared[tMaxSlot], DELTA);
+    assertFalse(trends.hasTrend(StationTrends.slot(Element.TMAX, 6)));
+    assertFalse(trends.hasTrend(StationTrends.slot(Element.TMIN, 7)));
+    // Regressing all the station years together mistakes the levels for a cooling trend.
+    assertTrue(merged[tMaxSlot].slope() < 0);
+  }
+
+  @Test
+  public void testTooFewYears() {
+    final StationTrends trends = StationTrends.compute(series(1900, 1900 + StationTrends.MIN_YEARS - 2));
+    assertFalse(trends.hasTrend(StationTrends.slot(Element.TMAX, 7)));
+    assertTrue(Double.isNaN(trends.meanSlope(Element.TMAX)));
+  }
+
+  @Test
+  public void testFile() throws Exception {
+    final File file = File.createTempFile("test", ".trends");
+    file.deleteOnExit();
+    final StationTrends trends = StationTrends.compute(series(1900, 1999));
+    StationTrendsFile.write(file, Collections.singletonList(trends));
+    final List<StationTrends> result = StationTrendsFile.read(file);
+    assertEquals(1, result.size());
+    assertEquals("USC00000001", result.get(0).stationId);
+    assertArrayEquals(trends.slopes, result.get(0).slopes, 0f);
+    assertArrayEquals(trends.years, result.get(0).years);
+
+    // Every length short of the full file, e.g. after an interrupted write.
+    final byte[] bytes = Files.readAllBytes(file.toPath());
+    for (int length = 0; length < bytes.length; length++) {
+      try (RandomAccessFile out = new RandomAccessFile(file, "rw")) {
+        out.setLength(0);
+        out.write(bytes, 0, length);
+      }
+      try {
+        StationTrendsFile.read(file);
+        fail("length " + length);
+      } catch (IOException e) {
+        // Expected.
+      }
+    }
+  }
+}
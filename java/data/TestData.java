@@ -0,0 +1,44 @@
+package data;
+
+import data.DataRecord.Type;
+
+import java.io.File;
+import java.io.PrintWriter;
+import java.util.Arrays;
+
+/** Builders of the input data shared by the tests of this package. */
+final class TestData {
+
+  private TestData() {
+  }
+
+  // A record of station "USC00000001" with the same raw value on all the days of the month.
+  static DataRecord record(int year, int month, Type type, int rawValue) {
+    final int[] rawValues = new int[DataRecord.MAX_DAYS_IN_MONTH];
+    Arrays.fill(rawValues, 0, StationSeries.daysInMonth(year, month), rawValue);
+    return new DataRecord(StationRegistry.packStationId("USC00000001", 0), year, month, type, rawValues);
+  }
+
+  // A .dly text line of the given station, month of 1950 and type with a single value.
+  static String textLine(String stationId, int month, String type, int rawValue) {
+    final StringBuilder builder = new StringBuilder(String.format("%s1950%02d%s", stationId, month, type));
+    for (int i = 0; i < 31; i++) {
+      builder.append(String.format("%5d   ", i == 0 ? rawValue : -9999));
+    }
+    return builder.toString();
+  }
+
+  // Loads a registry from a stations file with the given id, latitude and longitude per
+  // station.
+  static StationRegistry registry(String... stations) throws Exception {
+    final File file = File.createTempFile("ghcnd-stations", ".txt");
+    file.deleteOnExit();
+    try (PrintWriter writer = new PrintWriter(file)) {
+      for (int i = 0; i < stations.length; i += 3) {
+        writer.printf("%-11s %8s %9s %6s %-2s %-30s %3s %3s %5s\n", stations[i], stations[i + 1],
+            stations[i + 2], "10.0", "TX", "STATION " + i, "", "", "");
+      }
+    }
+    return StationRegistry.load(file);
+  }
+}
@@ -0,0 +1,392 @@
+package data;
+
+import java.util.Arrays;
+import java.util.Random;
+
+/**
+ * Theil-Sen slope estimator: the median of the slopes of all the pairs of points. Unlike
+ * least squares, it is insensitive to a minority of bad values.
+ *
+ * <p>With n points there are n(n-1)/2 slopes, so the median is selected without listing
+ * them, by randomized interval shrinking. The number of slopes at or below a value t is
+ * the number of inversions between the orders of the points by x and by y - t * x, which is
+ * counted in O(n log n) with a Fenwick tree. Each round draws n slopes uniformly from the
+ * current interval and shrinks it around the median rank, and once the interval has O(n)
+ * slopes they are listed and selected directly. The expected time is O(n log n).</p>
+ *
+ * <p>Instances keep scratch arrays and are not thread safe. Results don't depend on the
+ * random choices.</p>
+ */
+public class TheilSen {
+  // Point sets up to this size are handled by listing all the slopes.
+  private static final int NAIVE_MAX_POINTS = 32;
+  // Max number of shrinking rounds, a safety net for floating point ties.
+  private static final int MAX_ROUNDS = 64;
+
+  private final Random random;
+
+  // Scratch arrays, grown as needed.
+  private double[] xs = new double[0];
+  private double[] ys = new double[0];
+  private double[] keys = new double[0];
+  // Points ordered by their keys at the low end of the interval.
+  private int[] order = new int[0];
+  // Rank of each point by its key at the high end of the interval, and its inverse.
+  private int[] ranks = new int[0];
+  private int[] rankToPoint = new int[0];
+  // ranks[order[p]] for each position p.
+  private int[] sequence = new int[0];
+  private int[] mergeBuffer = new int[0];
+  // Per position p, the number of earlier positions with a larger rank.
+  private int[] counts = new int[0];
+  private int[] fenwick = new int[0];
+  private double[] samples = new double[0];
+  private long[] sampleRanks = new long[0];
+
+  public TheilSen(long seed) {
+    this.random = new Random(seed);
+  }
+
+  /**
+   * Returns the median of the pairwise slopes of the first n points, or NaN if n < 2. The
+   * x values must be strictly increasing.
+   */
+  public double slope(double[] x, double[] y, int n) {
+    if (n < 2) {
+      return Double.NaN;
+    }
+    for (int i = 1; i < n; i++) {
+      if (!(x[i] > x[i - 1])) {
+        throw new IllegalArgumentException("x values are not strictly increasing at " + i);
+      }
+    }
+    if (n <= NAIVE_MAX_POINTS) {
+      return slopeNaive(x, y, n);
+    }
+    ensureCapacity(n);
+    // Centering x reduces the rounding errors of the keys y - t * x.
+    final double meanX = (x[0] + x[n - 1]) / 2;
+    for (int i = 0; i < n; i++) {
+      xs[i] = x[i] - meanX;
+      ys[i] = y[i];
+    }
+    final long pairs = (long) n * (n - 1) / 2;
+    final long k = pairs / 2;
+    return (pairs % 2 == 1) ? selectSlope(n, pairs, k)
+        : (selectSlope(n, pairs, k - 1) + selectSlope(n, pairs, k)) / 2;
+  }
+
+  /** Same as slope() by listing all the pairwise slopes. O(n^2). */
+  public static double slopeNaive(double[] x, double[] y, int n) {
+    if (n < 2) {
+      return Double.NaN;
+    }
+    final double[] slopes = new double[n * (n - 1) / 2];
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+      for (int j = i + 1; j < n; j++) {
+        slopes[count++] = (y[j] - y[i]) / (x[j] - x[i]);
+      }
+    }
+    Arrays.sort(slopes);
+    return (count % 2 == 1) ? slopes[count / 2] : (slopes[count / 2 - 1] + slopes[count / 2]) / 2;
+  }
+
+  // Returns the k-th (0 based) smallest pairwise slope of the n points in xs, ys.
+  private double selectSlope(int n, long pairs, long k) {
+    // The selected slope is in (lo, hi], which has countHi - countLo slopes.
+    double lo = Double.NEGATIVE_INFINITY;
+    double hi = Double.POSITIVE_INFINITY;
+    long countLo = 0;
+    long countHi = pairs;
+    final double margin = 2 * Math.sqrt(n);
+    for (int round = 0; round < MAX_ROUNDS && countHi - countLo > n; round++) {
+      final int m = sampleSlopes(n, lo, hi, n);
+      if (m == 0) {
+        break;
+      }
+      final double position = (double) (k - countLo) / (countHi - countLo) * m;
+      final int loIndex = (int) Math.floor(position - margin);
+      final int hiIndex = (int) Math.ceil(position + margin);
+      double newLo = lo;
+      long newCountLo = countLo;
+      if (loIndex >= 0 && loIndex < m) {
+        newLo = samples[loIndex];
+        newCountLo = countSlopes(n, newLo, false);
+      }
+      double newHi = hi;
+      long newCountHi = countHi;
+      if (hiIndex >= 0 && hiIndex < m) {
+        newHi = samples[hiIndex];
+        newCountHi = countSlopes(n, newHi, false);
+      }
+      final long previousCountLo = countLo;
+      final long previousCountHi = countHi;
+      if (k < newCountLo) {
+        hi = newLo;
+        countHi = newCountLo;
+      } else if (k >= newCountHi) {
+        lo = newHi;
+        countLo = newCountHi;
+      } else {
+        lo = newLo;
+        countLo = newCountLo;
+        hi = newHi;
+        countHi = newCountHi;
+      }
+      if (countLo == previousCountLo && countHi == previousCountHi) {
+        // No progress, the interval has many slopes equal to hi.
+        final long countBelowHi = countSlopes(n, hi, true);
+        if (countBelowHi <= k) {
+          return hi;
+        }
+        hi = Math.nextDown(hi);
+        countHi = countBelowHi;
+      }
+    }
+    final double[] slopes = listSlopes(n, lo, hi, (int) (countHi - countLo));
+    Arrays.sort(slopes);
+    return slopes[(int) Math.max(0, Math.min(slopes.length - 1, k - countLo))];
+  }
+
+  // The order key of point i at slope t. For i < j, slope(i, j) <= t iff key(j) <= key(i).
+  private double key(double t, int i) {
+    if (t == Double.NEGATIVE_INFINITY) {
+      return xs[i];
+    }
+    if (t == Double.POSITIVE_INFINITY) {
+      return -xs[i];
+    }
+    return ys[i] - t * xs[i];
+  }
+
+  /**
+   * Prepares sequence[] such that the pairs of positions p < q with sequence[p] >
+   * sequence[q] are the pairs of points with slopes in (lo, hi], or in (lo, hi) if
+   * strictHi.
+   */
+  private void prepare(int n, double lo, double hi, boolean strictHi) {
+    // Order by key at lo, ties by decreasing index so pairs with slope lo are excluded.
+    for (int i = 0; i < n; i++) {
+      keys[i] = key(lo, i);
+      order[i] = i;
+    }
+    sortByKeys(order, n);
+    // Rank by key at hi. Ties are ranked by decreasing position to include pairs with
+    // slope hi, or by increasing position to exclude them.
+    for (int p = 0; p < n; p++) {
+      keys[order[p]] = key(hi, order[p]);
+      sequence[p] = order[p];
+    }
+    for (int p = 0; p < n; p++) {
+      ranks[order[p]] = p;
+    }
+    // sequence[] holds points, sorted by key at hi with ties by their position in order[].
+    sortByKeysAndPositions(sequence, n, strictHi);
+    for (int rank = 0; rank < n; rank++) {
+      rankToPoint[rank] = sequence[rank];
+    }
+    for (int rank = 0; rank < n; rank++) {
+      ranks[rankToPoint[rank]] = rank;
+    }
+    for (int p = 0; p < n; p++) {
+      sequence[p] = ranks[order[p]];
+    }
+  }
+
+  // Returns the number of slopes <= t, or < t if strict.
+  private long countSlopes(int n, double t, boolean strict) {
+    prepare(n, Double.NEGATIVE_INFINITY, t, strict);
+    return countInversions(n);
+  }
+
+  // Counts the pairs p < q with sequence[p] > sequence[q], and their number per q in counts[].
+  private long countInversions(int n) {
+    Arrays.fill(fenwick, 0);
+    long total = 0;
+    for (int p = 0; p < n; p++) {
+      // Earlier positions with a larger rank.
+      counts[p] = p - fenwickPrefix(sequence[p] + 1);
+      total += counts[p];
+      fenwickAdd(sequence[p] + 1);
+    }
+    return total;
+  }
+
+  /**
+   * Draws up to m slopes uniformly (with replacement) from the slopes in (lo, hi] into
+   * samples[], sorted. Returns the number of slopes drawn.
+   */
+  private int sampleSlopes(int n, double lo, double hi, int m) {
+    prepare(n, lo, hi, false);
+    final long total = countInversions(n);
+    if (total == 0) {
+      return 0;
+    }
+    for (int s = 0; s < m; s++) {
+      sampleRanks[s] = Math.min(total - 1, (long) (random.nextDouble() * total));
+    }
+    Arrays.sort(sampleRanks, 0, m);
+    // Second pass over the positions, picking the sampled pairs of each position.
+    Arrays.fill(fenwick, 0);
+    int s = 0;
+    long firstRankOfPosition = 0;
+    for (int p = 0; p < n && s < m; p++) {
+      while (s < m && sampleRanks[s] < firstRankOfPosition + counts[p]) {
+        // The earlier positions with a larger rank are the top counts[p] ranks inserted so
+        // far. Picks one of them by its offset.
+        final int offset = (int) (sampleRanks[s] - firstRankOfPosition);
+        final int rank = fenwickFind(p - offset) - 1;
+        final int a = rankToPoint[rank];
+        final int b = order[p];
+        samples[s++] = (ys[b] - ys[a]) / (xs[b] - xs[a]);
+      }
+      firstRankOfPosition += counts[p];
+      fenwickAdd(sequence[p] + 1);
+    }
+    Arrays.sort(samples, 0, s);
+    return s;
+  }
+
+  // Lists the slopes in (lo, hi], of which there are expected to be about 'expected'.
+  private double[] listSlopes(int n, double lo, double hi, int expected) {
+    prepare(n, lo, hi, false);
+    double[] result = new double[Math.max(expected, 16)];
+    int count = 0;
+    // Merge sort of the positions by sequence[], listing the inversions.
+    final int[] positions = new int[n];
+    for (int p = 0; p < n; p++) {
+      positions[p] = p;
+    }
+    final int[] buffer = mergeBuffer;
+    for (int width = 1; width < n; width *= 2) {
+      for (int start = 0; start + width < n; start += 2 * width) {
+        final int mid = start + width;
+        final int end = Math.min(start + 2 * width, n);
+        int i = start;
+        int j = mid;
+        int out = start;
+        while (i < mid && j < end) {
+          if (sequence[positions[i]] < sequence[positions[j]]) {
+            buffer[out++] = positions[i++];
+          } else {
+            // positions[i..mid) are earlier with a larger rank than positions[j].
+            final int b = order[positions[j]];
+            for (int l = i; l < mid; l++) {
+              final int a = order[positions[l]];
+              if (count == result.length) {
+                result = Arrays.copyOf(result, count * 2);
+              }
+              result[count++] = (ys[b] - ys[a]) / (xs[b] - xs[a]);
+            }
+            buffer[out++] = positions[j++];
+          }
+        }
+        while (i < mid) {
+          buffer[out++] = positions[i++];
+        }
+        while (j < end) {
+          buffer[out++] = positions[j++];
+        }
+        System.arraycopy(buffer, start, positions, start, end - start);
+      }
+    }
+    return Arrays.copyOf(result, count);
+  }
+
+  // Sorts the first n points of 'points' by keys[], ties by decreasing index.
+  private void sortByKeys(int[] points, int n) {
+    mergeSort(points, n, (a, b) -> {
+      final int c = compareKeys(a, b);
+      return c != 0 ? c : Integer.compare(b, a);
+    });
+  }
+
+  // Sorts the first n points of 'points' by keys[], ties by their position in order[]
+  // (stored in ranks[]), increasing if tiesAscending.
+  private void sortByKeysAndPositions(int[] points, int n, boolean tiesAscending) {
+    mergeSort(points, n, (a, b) -> {
+      final int c = compareKeys(a, b);
+      return c != 0 ? c
+          : (tiesAscending ? Integer.compare(ranks[a], ranks[b]) : Integer.compare(ranks[b], ranks[a]));
+    });
+  }
+
+  // Compares by value, unlike Double.compare() which orders -0.0 before 0.0.
+  private int compareKeys(int a, int b) {
+    return keys[a] < keys[b] ? -1 : (keys[a] > keys[b] ? 1 : 0);
+  }
+
+  private interface IntComparator {
+    int compare(int a, int b);
+  }
+
+  // Bottom up merge sort of the first n ints of values.
+  private void mergeSort(int[] values, int n, IntComparator comparator) {
+    for (int width = 1; width < n; width *= 2) {
+      for (int start = 0; start + width < n; start += 2 * width) {
+        final int mid = start + width;
+        final int end = Math.min(start + 2 * width, n);
+        int i = start;
+        int j = mid;
+        int out = start;
+        while (i < mid && j < end) {
+          mergeBuffer[out++] = comparator.compare(values[i], values[j]) <= 0 ? values[i++] : values[j++];
+        }
+        while (i < mid) {
+          mergeBuffer[out++] = values[i++];
+        }
+        while (j < end) {
+          mergeBuffer[out++] = values[j++];
+        }
+        System.arraycopy(mergeBuffer, start, values, start, end - start);
+      }
+    }
+  }
+
+  // Fenwick tree over ranks 1..n, counting the inserted ranks.
+  private void fenwickAdd(int index) {
+    for (int i = index; i < fenwick.length; i += i & -i) {
+      fenwick[i]++;
+    }
+  }
+
+  // Number of inserted ranks <= index.
+  private int fenwickPrefix(int index) {
+    int result = 0;
+    for (int i = index; i > 0; i -= i & -i) {
+      result += fenwick[i];
+    }
+    return result;
+  }
+
+  // The smallest index such that fenwickPrefix(index) >= k, for 1 <= k <= number inserted.
+  private int fenwickFind(int k) {
+    int index = 0;
+    for (int step = Integer.highestOneBit(fenwick.length - 1); step > 0; step >>= 1) {
+      if (index + step < fenwick.length && fenwick[index + step] < k) {
+        index += step;
+        k -= fenwick[index];
+      }
+    }
+    return index + 1;
+  }
+
+  private void ensureCapacity(int n) {
+    if (xs.length >= n) {
+      return;
+    }
+    xs = new double[n];
+    ys = new double[n];
+    keys = new double[n];
+    order = new int[n];
+    ranks = new int[n];
+    rankToPoint = new int[n];
+    sequence = new int[n];
+    mergeBuffer = new int[n];
+    counts = new int[n];
+    fenwick = new int[n + 1];
+    samples = new double[n];
+    sampleRanks = new long[n];
+  }
+}
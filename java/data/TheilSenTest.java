@@ -0,0 +1,70 @@
+package data;
+
+import org.junit.Test;
+
+import java.util.Random;
+
+import static org.junit.Assert.*;
+
+public class TheilSenTest {
+
+  private static final double DELTA = 1e-9;
+
+  private static double[] years(int first, int count) {
+    final double[] result = new double[count];
+    for (int i = 0; i < count; i++) {
+      result[i] = first + i;
+    }
+    return result;
+  }
+
+  @Test
+  public void testExactLine() {
+    final double[] x = years(1850, 168);
+    final double[] y = new double[x.length];
+    for (int i = 0; i < x.length; i++) {
+      y[i] = 0.01 * x[i] - 5;
+    }
+    assertEquals(0.01, new TheilSen(1).slope(x, y, x.length), DELTA);
+  }
+
+  @Test
+  public void testOutliers() {
+    // A flat series with 20% of the years far off doesn't get a trend.
+    final double[] x = years(1900, 100);
+    final double[] y = new double[x.length];
+    for (int i = 0; i < x.length; i++) {
+      y[i] = (i % 5 == 0) ? 10 * i : 15;
+    }
+    assertEquals(0, new TheilSen(1).slope(x, y, x.length), DELTA);
+  }
+
+  @Test
+  public void testMatchesNaive() {
+    final Random random = new Random(7);
+    final TheilSen theilSen = new TheilSen(3);
+    for (int trial = 0; trial < 200; trial++) {
+      final int n = 2 + random.nextInt(200);
+      final double[] x = new double[n];
+      final double[] y = new double[n];
+      int year = 1800;
+      for (int i = 0; i < n; i++) {
+        year += 1 + random.nextInt(3);
+        x[i] = year;
+        // Some trials have many equal values, so many equal slopes.
+        y[i] = (trial % 3 == 0) ? random.nextInt(3) : 0.02 * year + random.nextGaussian();
+      }
+      assertEquals("trial " + trial, TheilSen.slopeNaive(x, y, n), theilSen.slope(x, y, n), DELTA);
+    }
+  }
+
+  @Test
+  public void testTooFewPoints() {
+    assertTrue(Double.isNaN(new TheilSen(1).slope(new double[] {2000}, new double[] {1}, 1)));
+  }
+
+  @Test(expected = IllegalArgumentException.class)
+  public void testUnsortedX() {
+    new TheilSen(1).slope(new double[] {2000, 1999, 2001}, new double[] {1, 2, 3}, 3);
+  }
+}
@@ -0,0 +1,63 @@
+package data;
+
+/**
+ * Indexing of per year rows of totals that are accumulated over the years, so the totals of
+ * any window of years are the difference of two rows. Used by StationClimatology and
+ * StationCube.
+ *
+ * <p>Row r in [0, numYears] holds the totals of the years [firstYear, firstYear + r). Values
+ * are first added to the row of their year only, with index(), and accumulate() then turns
+ * the per year totals into the cumulative ones.</p>
+ */
+final class YearPrefix {
+  // The years range of the data. numYears is 0 if the station has no data.
+  final int firstYear;
+  final int numYears;
+  // Number of entries per row.
+  final int rowSize;
+
+  /** The rows of the years range of the given series. */
+  YearPrefix(StationSeries series, int rowSize) {
+    this.firstYear = series.isEmpty() ? 0 : series.firstYear();
+    this.numYears = series.isEmpty() ? 0 : series.lastYear() - series.firstYear() + 1;
+    this.rowSize = rowSize;
+  }
+
+  /** Number of entries of all the rows. */
+  int size() {
+    return (numYears + 1) * rowSize;
+  }
+
+  /** The index of the given entry of a row in the row of the given year's values. */
+  int index(int year, int entry) {
+    return (year - firstYear + 1) * rowSize + entry;
+  }
+
+  /** Accumulates the per year totals over the years. */
+  void accumulate(long[] totals) {
+    for (int i = rowSize; i < totals.length; i++) {
+      totals[i] += totals[i - rowSize];
+    }
+  }
+
+  /**
+   * Accumulates the per year totals over the years, for totals with the given number of
+   * values per entry.
+   */
+  void accumulate(int[] totals, int valuesPerEntry) {
+    final int stride = rowSize * valuesPerEntry;
+    for (int i = stride; i < totals.length; i++) {
+      totals[i] += totals[i - stride];
+    }
+  }
+
+  /** The row of the totals before the given year, clamped to the years range. */
+  int beginRow(int year) {
+    return Math.max(0, Math.min(numYears, year - firstYear));
+  }
+
+  /** The row of the totals up to the given year, inclusive, clamped to the years range. */
+  int endRow(int lastYear) {
+    return Math.max(0, Math.min(numYears, lastYear - firstYear + 1));
+  }
+}
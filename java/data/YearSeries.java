@@ -0,0 +1,86 @@
+package data;
+
+import com.sun.istack.internal.Nullable;
+
+import java.util.function.BiConsumer;
+import java.util.function.Supplier;
+
+/**
+ * A dense per year container, indexed by year - FIRST_YEAR. A faster alternative to a
+ * Map keyed by year for per year accumulators that are updated for each data record.
+ */
+public class YearSeries<T> {
+  // Range of supported years. GHCN data starts at 1763.
+  public static final int FIRST_YEAR = 1700;
+  public static final int LAST_YEAR = 2100;
+  public static final int NUMBER_OF_YEARS = LAST_YEAR - FIRST_YEAR + 1;
+
+  private final Supplier<T> factory;
+  private final Object[] entries = new Object[NUMBER_OF_YEARS];
+
+  // Range of years with entries. minYear > maxYear if empty.
+  private int minYear = LAST_YEAR + 1;
+  private int maxYear = FIRST_YEAR - 1;
+
+  /**
+   * @param factory creates the entry of a year on its first getOrCreate().
+   */
+  public YearSeries(Supplier<T> factory) {
+    this.factory = factory;
+  }
+
+  /** Returns the entry of the given year or null if none. */
+  @Nullable
+  @SuppressWarnings("unchecked")
+  public T get(int year) {
+    return (year < FIRST_YEAR || year > LAST_YEAR) ? null : (T) entries[year - FIRST_YEAR];
+  }
+
+  /** Returns the entry of the given year, creating it if needed. */
+  public T getOrCreate(int year) {
+    T entry = get(year);
+    if (entry == null) {
+      if (year < FIRST_YEAR || year > LAST_YEAR) {
+        throw new IllegalArgumentException("Year out of range: " + year);
+      }
+      entry = factory.get();
+      entries[year - FIRST_YEAR] = entry;
+      minYear = Math.min(minYear, year);
+      maxYear = Math.max(maxYear, year);
+    }
+    return entry;
+  }
+
+  /**
+   * Merges the entries of another series into this one, in increasing years. For each year
+   * with an entry in other, calls merger with this series' entry of that year, created if
+   * needed, and the entry of other.
+   */
+  public void mergeFrom(YearSeries<T> other, BiConsumer<T, T> merger) {
+    for (int year = other.minYear; year <= other.maxYear; year++) {
+      final T otherEntry = other.get(year);
+      if (otherEntry != null) {
+        merger.accept(getOrCreate(year), otherEntry);
+      }
+    }
+  }
+
+  public boolean isEmpty() {
+    return minYear > maxYear;
+  }
+
+  /**
+   * Return a sorted array with all the years between the min and max years with entries.
+   * Useful to generate annual analysis results.
+   */
+  public int[] yearRange() {
+    if (isEmpty()) {
+      return new int[0];
+    }
+    final int[] result = new int[maxYear - minYear + 1];
+    for (int i = 0; i < result.length; i++) {
+      result[i] = minYear + i;
+    }
+    return result;
+  }
+}
@@ -0,0 +1,67 @@
+package geo;
+
+/**
+ * A latitude/longitude bounding box, in degrees. If minLon > maxLon the box crosses the
+ * antimeridian and spans [minLon, 180] and [-180, maxLon].
+ */
+public class GeoBox {
+  public final double minLat;
+  public final double minLon;
+  public final double maxLat;
+  public final double maxLon;
+
+  public GeoBox(double minLat, double minLon, double maxLat, double maxLon) {
+    if (minLat > maxLat || minLat < -90 || maxLat > 90 || minLon < -180 || maxLon > 180) {
+      throw new IllegalArgumentException(
+          String.format("Invalid bounding box: [%s,%s,%s,%s]", minLat, minLon, maxLat, maxLon));
+    }
+    this.minLat = minLat;
+    this.minLon = minLon;
+    this.maxLat = maxLat;
+    this.maxLon = maxLon;
+  }
+
+  /** Returns the smallest box that contains all the points within the given distance. */
+  public static GeoBox around(GeoPoint center, double radiusMeters) {
+    final double angularRadius = radiusMeters / GeoPoint.AVERAGE_RADIUS_OF_EARTH_METERS;
+    final double deltaLat = Math.toDegrees(angularRadius);
+    final double minLat = center.lat - deltaLat;
+    final double maxLat = center.lat + deltaLat;
+    // Includes a pole, all longitudes are in range.
+    if (minLat <= -90 || maxLat >= 90) {
+      return new GeoBox(Math.max(minLat, -90), -180, Math.min(maxLat, 90), 180);
+    }
+    final double sinDeltaLon = Math.sin(angularRadius) / Math.cos(Math.toRadians(center.lat));
+    if (sinDeltaLon >= 1 || angularRadius >= Math.PI / 2) {
+      return new GeoBox(minLat, -180, maxLat, 180);
+    }
+    final double deltaLon = Math.toDegrees(Math.asin(sinDeltaLon));
+    double minLon = center.lon - deltaLon;
+    double maxLon = center.lon + deltaLon;
+    if (minLon < -180) {
+      minLon += 360;
+    }
+    if (maxLon > 180) {
+      maxLon -= 360;
+    }
+    return new GeoBox(minLat, minLon, maxLat, maxLon);
+  }
+
+  public boolean crossesAntimeridian() {
+    return minLon > maxLon;
+  }
+
+  public boolean contains(double lat, double lon) {
+    if (lat < minLat || lat > maxLat) {
+      return false;
+    }
+    return crossesAntimeridian()
+        ? lon >= minLon || lon <= maxLon
+        : lon >= minLon && lon <= maxLon;
+  }
+
+  @Override
+  public String toString() {
+    return String.format("[%.4f,%.4f,%.4f,%.4f]", minLat, minLon, maxLat, maxLon);
+  }
+}
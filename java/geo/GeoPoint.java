@@ -1,25 +1,32 @@
 package geo;
 
 public class GeoPoint {
-  private final static double AVERAGE_RADIUS_OF_EARTH_METERS = 6371_000;
+  final static double AVERAGE_RADIUS_OF_EARTH_METERS = 6371_000;
 
   public final float lat;
   public final float lon;
 
+  // Computed once since distanceMeters() is called per station and query.
+  private final double latRad;
+  private final double lonRad;
+  private final double cosLat;
+
   public GeoPoint(float lat, float lon) {
     this.lat = lat;
     this.lon = lon;
+    this.latRad = Math.toRadians(lat);
+    this.lonRad = Math.toRadians(lon);
+    this.cosLat = Math.cos(latRad);
   }
 
   // Based on an answer by whostolebenfrog@ here"
   // https://stackoverflow.com/questions/27928/calculate-distance-between-two-latitude-longitude-points-haversine-formula
   public double distanceMeters(GeoPoint other) {
-    final double deltaLatRad = Math.toRadians(lat - other.lat);
-    final double deltaLonRad = Math.toRadians(lon - other.lon);
+    final double sinHalfDeltaLat = Math.sin((latRad - other.latRad) / 2);
+    final double sinHalfDeltaLon = Math.sin((lonRad - other.lonRad) / 2);
 
-    final double a = Math.sin(deltaLatRad / 2) * Math.sin(deltaLatRad / 2)
-      + Math.cos(Math.toRadians(lat)) * Math.cos(Math.toRadians(other.lat))
-      * Math.sin(deltaLonRad / 2) * Math.sin(deltaLonRad / 2);
+    final double a = sinHalfDeltaLat * sinHalfDeltaLat
+      + cosLat * other.cosLat * sinHalfDeltaLon * sinHalfDeltaLon;
 
     final double c = 2 * Math.atan2(Math.sqrt(a), Math.sqrt(1 - a));
 